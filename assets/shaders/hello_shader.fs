@@ -31,22 +31,32 @@ struct PointLight {
 in vec2 fragmentUV;
 in vec3 fragmentPos;
 in vec3 fragmentNormal;
+in vec4 fragmentColor;
 
 uniform vec3 COLOR;
 uniform Material MATERIAL;
 uniform DirectionalLight DIRECTIONALLIGHT;
 uniform PointLight POINTLIGHTS[4];
 uniform int NUMBEROFPOINTLIGHTS;
-uniform float TIME;
 
-uniform vec3 VIEWPOS;
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    mat4 VIEW_PROJECTION;
+    vec4 CAMERA_POSITION;
+    vec2 VIEWPORT;
+    float TIME;
+    float DELTA_TIME;
+};
 
 vec3 CalculateDirectionalLight(DirectionalLight _directionalLight);
 vec3 CalculatePointLight(PointLight _pointLight);
 
 void main() {
 	// base color
-	vec4 color = texture(MATERIAL.diffuse, fragmentUV) * vec4(COLOR, 1.0);
+	vec4 color = texture(MATERIAL.diffuse, fragmentUV) * vec4(COLOR, 1.0) * fragmentColor;
 
     if (color.a <= 0.0)
     {
@@ -73,7 +83,7 @@ vec3 CalculateDirectionalLight(DirectionalLight _directionalLight)
     vec3 diffuse = _directionalLight.diffuse * diff;  
     
     // specular
-    vec3 viewDir = normalize(VIEWPOS - fragmentPos);
+    vec3 viewDir = normalize(CAMERA_POSITION.xyz - fragmentPos);
     vec3 reflectDir = reflect(-lightDir, norm);  
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), MATERIAL.shininess);
     vec3 specular = _directionalLight.specular * spec * texture(MATERIAL.specular, fragmentUV).rgb;  
@@ -93,7 +103,7 @@ vec3 CalculatePointLight(PointLight _pointLight)
     vec3 diffuse = _pointLight.diffuse * diff;  
     
     // specular
-    vec3 viewDir = normalize(VIEWPOS - fragmentPos);
+    vec3 viewDir = normalize(CAMERA_POSITION.xyz - fragmentPos);
     vec3 reflectDir = reflect(-lightDir, norm);  
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), MATERIAL.shininess);
     vec3 specular = _pointLight.specular * spec * texture(MATERIAL.specular, fragmentUV).rgb;  
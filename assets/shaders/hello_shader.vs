@@ -3,27 +3,41 @@
 in vec3 aPosition;
 in vec3 aNormal;
 in vec2 aUV;
+// offset xyz and scale w that turn a compact model's 16 bit position back into model space, see Canis::Model
+layout(location = 9) in vec4 aPositionDecode;
 
 out vec2 fragmentUV;
 out vec3 fragmentPos;
 out vec3 fragmentNormal;
+out vec4 fragmentColor;
+
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    mat4 VIEW_PROJECTION;
+    vec4 CAMERA_POSITION;
+    vec2 VIEWPORT;
+    float TIME;
+    float DELTA_TIME;
+};
 
 uniform mat4 TRANSFORM;
-uniform mat4 VIEW;
-uniform mat4 PROJECTION;
-uniform float TIME;
 uniform bool WIND;
 uniform float WINDEFFECT;
 
 void main()
 {
+    vec3 position = aPositionDecode.xyz + aPosition * aPositionDecode.w;
     float offset = 0.0;
 
     if (WIND)
-        offset = sin(TIME) * (aPosition.y + 0.5) * WINDEFFECT;
+        offset = sin(TIME) * (position.y + 0.5) * WINDEFFECT;
 
-    fragmentPos = vec3(TRANSFORM * vec4(aPosition + vec3(offset, 0.0, offset), 1.0));
+    fragmentPos = vec3(TRANSFORM * vec4(position + vec3(offset, 0.0, offset), 1.0));
     fragmentNormal = aNormal;
     fragmentUV = vec2(aUV.x, -aUV.y);
-    gl_Position = PROJECTION * VIEW * vec4(fragmentPos, 1.0);
+    fragmentColor = vec4(1.0);
+    gl_Position = VIEW_PROJECTION * vec4(fragmentPos, 1.0);
 }
\ No newline at end of file
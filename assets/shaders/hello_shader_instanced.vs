@@ -0,0 +1,46 @@
+#version 330 core
+
+// hello_shader.vs with the transform, color and wind phase read per instance, pairs with hello_shader.fs
+// the locations match Canis::ModelInstance
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aUV;
+layout(location = 3) in mat4 aInstanceTransform;
+layout(location = 7) in vec4 aInstanceColor;
+layout(location = 8) in float aInstanceWindPhase;
+layout(location = 9) in vec4 aPositionDecode; // constant per model, see Canis::MODEL_POSITION_DECODE_LOCATION
+
+out vec2 fragmentUV;
+out vec3 fragmentPos;
+out vec3 fragmentNormal;
+out vec4 fragmentColor;
+
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    mat4 VIEW_PROJECTION;
+    vec4 CAMERA_POSITION;
+    vec2 VIEWPORT;
+    float TIME;
+    float DELTA_TIME;
+};
+
+uniform bool WIND;
+uniform float WINDEFFECT;
+
+void main()
+{
+    vec3 position = aPositionDecode.xyz + aPosition * aPositionDecode.w;
+    float offset = 0.0;
+
+    if (WIND)
+        offset = sin(TIME + aInstanceWindPhase) * (position.y + 0.5) * WINDEFFECT;
+
+    fragmentPos = vec3(aInstanceTransform * vec4(position + vec3(offset, 0.0, offset), 1.0));
+    fragmentNormal = mat3(aInstanceTransform) * aNormal;
+    fragmentUV = vec2(aUV.x, -aUV.y);
+    fragmentColor = aInstanceColor;
+    gl_Position = VIEW_PROJECTION * vec4(fragmentPos, 1.0);
+}
\ No newline at end of file
@@ -1,9 +1,18 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    mat4 VIEW_PROJECTION;
+    vec4 CAMERA_POSITION;
+    vec2 VIEWPORT;
+    float TIME;
+    float DELTA_TIME;
+};
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = VIEW_PROJECTION * model * vec4(aPos, 1.0);
 }
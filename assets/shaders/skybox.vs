@@ -3,8 +3,17 @@ layout (location = 0) in vec3 aPosition;
 
 out vec3 texCoords;
 
-uniform mat4 PROJECTION;
-uniform mat4 VIEW;
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    mat4 VIEW_PROJECTION;
+    vec4 CAMERA_POSITION;
+    vec2 VIEWPORT;
+    float TIME;
+    float DELTA_TIME;
+};
 
 void main()
 {
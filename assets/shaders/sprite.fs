@@ -3,7 +3,17 @@ out vec4 FragColor;
 in vec3 color;
 in vec2 uv;
 uniform vec4 COLOR;
-uniform float TIME;
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   mat4 VIEW_PROJECTION;
+   vec4 CAMERA_POSITION;
+   vec2 VIEWPORT;
+   float TIME;
+   float DELTA_TIME;
+};
 uniform sampler2D texture1;
 void main()
 {
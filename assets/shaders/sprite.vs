@@ -3,13 +3,21 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aUV;
 out vec3 color;
 out vec2 uv;
-uniform float TIME;
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   mat4 VIEW_PROJECTION;
+   vec4 CAMERA_POSITION;
+   vec2 VIEWPORT;
+   float TIME;
+   float DELTA_TIME;
+};
 uniform mat4 TRANSFORM;
-uniform mat4 PROJECTION;
-uniform mat4 VIEW;
 void main()
 {
-   gl_Position = PROJECTION * VIEW * TRANSFORM * vec4(aPos, 1.0f);
+   gl_Position = VIEW_PROJECTION * TRANSFORM * vec4(aPos, 1.0f);
    //gl_Position = vec4(aPos.x + sin(TIME)*0.5f, aPos.y + cos(TIME)*0.5f, aPos.z, 1.0);
    uv = aUV;
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#version 330 core
+out vec4 FragColor;
+in vec4 color;
+in vec2 uv;
+flat in uint slot;
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   mat4 VIEW_PROJECTION;
+   vec4 CAMERA_POSITION;
+   vec2 VIEWPORT;
+   float TIME;
+   float DELTA_TIME;
+};
+// one texture per unit, glsl 330 can only index a sampler array with a constant so the slot picks a case
+uniform sampler2D TEXTURES[16];
+void main()
+{
+   // taken outside the switch, the slot can change between neighbouring pixels at a sprite's edge
+   vec2 dx = dFdx(uv);
+   vec2 dy = dFdy(uv);
+   switch (slot)
+   {
+      default:
+      case 0u: FragColor = textureGrad(TEXTURES[0], uv, dx, dy); break;
+      case 1u: FragColor = textureGrad(TEXTURES[1], uv, dx, dy); break;
+      case 2u: FragColor = textureGrad(TEXTURES[2], uv, dx, dy); break;
+      case 3u: FragColor = textureGrad(TEXTURES[3], uv, dx, dy); break;
+      case 4u: FragColor = textureGrad(TEXTURES[4], uv, dx, dy); break;
+      case 5u: FragColor = textureGrad(TEXTURES[5], uv, dx, dy); break;
+      case 6u: FragColor = textureGrad(TEXTURES[6], uv, dx, dy); break;
+      case 7u: FragColor = textureGrad(TEXTURES[7], uv, dx, dy); break;
+      case 8u: FragColor = textureGrad(TEXTURES[8], uv, dx, dy); break;
+      case 9u: FragColor = textureGrad(TEXTURES[9], uv, dx, dy); break;
+      case 10u: FragColor = textureGrad(TEXTURES[10], uv, dx, dy); break;
+      case 11u: FragColor = textureGrad(TEXTURES[11], uv, dx, dy); break;
+      case 12u: FragColor = textureGrad(TEXTURES[12], uv, dx, dy); break;
+      case 13u: FragColor = textureGrad(TEXTURES[13], uv, dx, dy); break;
+      case 14u: FragColor = textureGrad(TEXTURES[14], uv, dx, dy); break;
+      case 15u: FragColor = textureGrad(TEXTURES[15], uv, dx, dy); break;
+   }
+   FragColor *= color;
+}
\ No newline at end of file
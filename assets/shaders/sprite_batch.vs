@@ -0,0 +1,26 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aUV;
+layout (location = 2) in vec4 aColor;
+layout (location = 3) in uint aSlot;
+out vec4 color;
+out vec2 uv;
+flat out uint slot;
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   mat4 VIEW_PROJECTION;
+   vec4 CAMERA_POSITION;
+   vec2 VIEWPORT;
+   float TIME;
+   float DELTA_TIME;
+};
+void main()
+{
+   gl_Position = VIEW_PROJECTION * vec4(aPos, 1.0f);
+   color = aColor;
+   uv = aUV;
+   slot = aSlot;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#version 330 core
+out vec4 FragColor;
+in vec4 color;
+in vec2 uv;
+flat in uint slot;
+// per frame camera and time, shared by every shader through Canis::FrameUniformBuffer
+layout(std140) uniform FrameData
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   mat4 VIEW_PROJECTION;
+   vec4 CAMERA_POSITION;
+   vec2 VIEWPORT;
+   float TIME;
+   float DELTA_TIME;
+};
+// every sprite of a batch reads the same array, the slot is the layer
+uniform sampler2DArray TEXTURE_ARRAY;
+void main()
+{
+   FragColor = texture(TEXTURE_ARRAY, vec3(uv, float(slot))) * color;
+}
\ No newline at end of file
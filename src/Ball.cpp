@@ -1,29 +1,22 @@
 #include "Ball.hpp"
 
-#include "Paddle.hpp"
-
 using namespace glm;
 
 void Ball::Start() {
     name = "Ball";
-    position = vec3(window->GetScreenWidth() * 0.5f, window->GetScreenHeight() * 0.5f, 0.0f);
+    vec2 viewport = world->GetViewportSize();
+    position = vec3(viewport.x * 0.5f, viewport.y * 0.5f, 0.0f);
     scale = vec3(100.0f, 100.0f, 0.0f);
+
+    if (window != nullptr)
+        window->SetWindowName("Pong");
 }
 
-void Ball::Update(float _dt) {
-    window->SetWindowName("Pong");
+void Ball::ParallelUpdate(float _dt) {
+    vec2 viewport = world->GetViewportSize();
 
-    if (dir == vec2(0.0f))
-    {
-        if (inputManager->GetKey(SDL_SCANCODE_SPACE))
-        {
-            vec2 directions[] = {vec2(1.0f, 1.0f), vec2(1.0f, -1.0f), vec2(-1.0f, 1.0f), vec2(-1.0f, -1.0f)};
-            dir = directions[rand()%4];
-        }
-    }
-    
-    if (position.y > window->GetScreenHeight() - (scale.y * 0.5f)) {
-        position.y = window->GetScreenHeight() - (scale.y * 0.5f);
+    if (position.y > viewport.y - (scale.y * 0.5f)) {
+        position.y = viewport.y - (scale.y * 0.5f);
         dir.y = abs(dir.y) * -1.0f;
     }
     if (position.y < scale.y * 0.5f) {
@@ -32,38 +25,41 @@ void Ball::Update(float _dt) {
     }
 
     // detect score
-    if (position.x > window->GetScreenWidth() - (scale.x * 0.5f)) {
-        position = vec3(window->GetScreenWidth()*0.5f, window->GetScreenHeight()*0.5f, 0.0f);
+    if (position.x > viewport.x - (scale.x * 0.5f)) {
+        Teleport(vec3(viewport.x*0.5f, viewport.y*0.5f, 0.0f));
         dir = vec2(0.0f);
     }
     if (position.x < scale.x * 0.5f) {
-        position = vec3(window->GetScreenWidth()*0.5f, window->GetScreenHeight()*0.5f, 0.0f);
+        Teleport(vec3(viewport.x*0.5f, viewport.y*0.5f, 0.0f));
         dir = vec2(0.0f);
     }
 
-    // detect if ball hits left paddle
-    Paddle* leftPaddle = world->FindByName<Paddle>("LeftPaddle"); 
-    if (EntityOverlap2D(*this ,*leftPaddle)) {
-        dir.x = abs(dir.x);
-    }
-
-    // detect if ball hits right paddle
-    Paddle* rightPaddle = world->FindByName<Paddle>("RightPaddle"); 
-    if (EntityOverlap2D(*this ,*rightPaddle)) {
-        dir.x = abs(dir.x) * -1.0f;
-    }
-
     if (dir != vec2(0.0f))
         position += vec3(dir.x, dir.y, 0.0f) * speed * _dt;
 }
 
-void Ball::Draw() {mat4 transform = mat4(1.0f);
-    transform = translate(transform, position);
-    transform = glm::scale(transform, scale);
+// the serve stays on the main thread with the rest of the input handling
+void Ball::Update(float _dt) {
+    if (dir == vec2(0.0f))
+    {
+        if (input->GetKey(SDL_SCANCODE_SPACE))
+        {
+            vec2 directions[] = {vec2(1.0f, 1.0f), vec2(1.0f, -1.0f), vec2(-1.0f, 1.0f), vec2(-1.0f, -1.0f)};
+            dir = directions[world->TickRandom(handle.index) % 4];
+        }
+    }
+}
+
+void Ball::Draw(Canis::RenderQueue &_queue) {
+    Canis::RenderCommand command;
+    command.shader = &shader;
+    command.texture = texture.id;
+    command.vao = world->VAO;
+    command.indexCount = 6;
+    command.transform = world->GetWorldMatrix(*this);
+    command.color = color;
 
-    // set shader variables
-    shader.SetVec4("COLOR", color);
-    shader.SetMat4("TRANSFORM", transform);
+    _queue.Submit(command, layer, translucent);
 }
 
 void Ball::OnDestroy() {
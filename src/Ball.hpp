@@ -7,8 +7,9 @@
 class Ball : public Entity {
 public:
     void Start();
+    void ParallelUpdate(float _dt);
     void Update(float _dt);
-    void Draw();
+    void Draw(Canis::RenderQueue &_queue);
     void OnDestroy();
 
     float speed = 100.0f;
@@ -0,0 +1,245 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "Ball.hpp"
+#include "Paddle.hpp"
+#include "World.hpp"
+#include "Canis/AABBBatch.hpp"
+#include "Canis/RenderQueue.hpp"
+
+using namespace glm;
+
+namespace
+{
+    const int BENCHMARK_FRAMES = 60;
+    const float BENCHMARK_DT = 1.0f / 60.0f;
+    const vec2 BENCHMARK_DIRECTIONS[] = {vec2(1.0f, 1.0f), vec2(1.0f, -1.0f), vec2(-1.0f, 1.0f), vec2(-1.0f, -1.0f)};
+
+    double TimeFrames(World &_world) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (int frame = 0; frame < BENCHMARK_FRAMES; frame++)
+        {
+            _world.Simulate(BENCHMARK_DT);
+            _world.SubmitSprites();
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / BENCHMARK_FRAMES;
+    }
+
+    double BenchmarkObjects(World &_world, int _count) {
+        _world.storageMode = StorageMode::OBJECTS;
+
+        Paddle *left = _world.Instantiate<Paddle>("LeftPaddle");
+        left->Teleport(vec3(10.0f*0.5f, _world.GetViewportSize().y * 0.5f, 0.0f));
+
+        Paddle *right = _world.Instantiate<Paddle>("RightPaddle");
+        right->Teleport(vec3(_world.GetViewportSize().x - (10.0f*0.5f), _world.GetViewportSize().y * 0.5f, 0.0f));
+
+        for (int i = 0; i < _count; i++)
+        {
+            Ball *ball = _world.Instantiate<Ball>();
+            ball->dir = BENCHMARK_DIRECTIONS[i % 4];
+        }
+
+        double ms = TimeFrames(_world);
+
+        for (Entity *entity : _world.entities)
+            _world.Destroy(entity);
+
+        _world.FlushDestroyed();
+
+        return ms;
+    }
+
+    double BenchmarkComponents(World &_world, int _count) {
+        _world.storageMode = StorageMode::COMPONENTS;
+        _world.components.Reserve(_count + 2);
+
+        SpawnPaddle(_world, {}, 10.0f*0.5f, SDL_SCANCODE_W, SDL_SCANCODE_S);
+        SpawnPaddle(_world, {}, _world.GetViewportSize().x - (10.0f*0.5f), SDL_SCANCODE_UP, SDL_SCANCODE_DOWN);
+
+        for (int i = 0; i < _count; i++)
+        {
+            size_t row = SpawnBall(_world, {});
+            _world.components.direction[row] = BENCHMARK_DIRECTIONS[i % 4];
+        }
+
+        double ms = TimeFrames(_world);
+
+        _world.ClearRows();
+
+        return ms;
+    }
+
+    // despawns and respawns a tenth of the balls every frame, after the warm up frames the pools should stop growing
+    void BenchmarkSpawnChurn(World &_world, int _count) {
+        _world.storageMode = StorageMode::OBJECTS;
+
+        std::vector<Ball*> balls;
+        balls.reserve(_count);
+
+        for (int i = 0; i < _count; i++)
+            balls.push_back(_world.Instantiate<Ball>());
+
+        int churn = _count / 10;
+        size_t warmChunks = 0;
+
+        for (int frame = 0; frame < BENCHMARK_FRAMES; frame++)
+        {
+            for (int i = 0; i < churn; i++)
+                _world.Destroy(balls[(frame * churn + i) % _count]);
+
+            _world.FlushDestroyed();
+
+            for (int i = 0; i < churn; i++)
+                balls[(frame * churn + i) % _count] = _world.Instantiate<Ball>();
+
+            if (frame == 0)
+                warmChunks = _world.GetPoolStats().chunkCount;
+        }
+
+        Canis::PoolStats stats = _world.GetPoolStats<Ball>();
+        Canis::Log("spawn churn " + std::to_string(_count) + " balls: live " + std::to_string(stats.liveObjects) +
+                   ", peak " + std::to_string(stats.peakLiveObjects) + ", chunks " + std::to_string(stats.chunkCount) +
+                   ", chunks added after warm up " + std::to_string(_world.GetPoolStats().chunkCount - warmChunks));
+
+        for (Entity *entity : _world.entities)
+            _world.Destroy(entity);
+
+        _world.FlushDestroyed();
+    }
+}
+
+void RunStorageBenchmark(World &_world) {
+    StorageMode previousMode = _world.storageMode;
+    int counts[] = {1000, 10000, 100000};
+
+    Canis::JobSystem *jobSystem = _world.jobSystem;
+    std::string workers = jobSystem ? std::to_string(jobSystem->GetWorkerCount()) : "0";
+
+    for (int count : counts)
+    {
+        _world.jobSystem = nullptr;
+        double objectsMs = BenchmarkObjects(_world, count);
+        double componentsMs = BenchmarkComponents(_world, count);
+
+        _world.jobSystem = jobSystem;
+        double objectsParallelMs = BenchmarkObjects(_world, count);
+        double componentsParallelMs = BenchmarkComponents(_world, count);
+
+        Canis::Log("benchmark " + std::to_string(count) + " entities: objects " + std::to_string(objectsMs) +
+                   " ms/frame, components " + std::to_string(componentsMs) + " ms/frame, with " + workers +
+                   " workers objects " + std::to_string(objectsParallelMs) + " ms/frame, components " +
+                   std::to_string(componentsParallelMs) + " ms/frame");
+    }
+
+    BenchmarkSpawnChurn(_world, 10000);
+
+    _world.storageMode = previousMode;
+}
+
+void RunOverlapBenchmark() {
+    const int BOX_COUNT = 100000;
+    const int QUERY_COUNT = 1000;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(0.0f, 10000.0f);
+    std::uniform_real_distribution<float> size(1.0f, 100.0f);
+
+    auto randomBox = [&]() {
+        vec2 min = vec2(position(rng), position(rng));
+        return Canis::AABB2D{min, min + vec2(size(rng), size(rng))};
+    };
+
+    Canis::AABBArray2D boxes;
+    boxes.Reserve(BOX_COUNT);
+    for (int i = 0; i < BOX_COUNT; i++)
+        boxes.Push(randomBox());
+
+    std::vector<Canis::AABB2D> queries;
+    for (int i = 0; i < QUERY_COUNT; i++)
+        queries.push_back(randomBox());
+
+    std::vector<unsigned int> scalarHits;
+    std::vector<unsigned int> simdHits;
+    scalarHits.reserve(BOX_COUNT);
+    simdHits.reserve(BOX_COUNT);
+
+    double scalarMs = 0.0;
+    double simdMs = 0.0;
+    bool match = true;
+
+    for (const Canis::AABB2D &query : queries)
+    {
+        scalarHits.clear();
+        simdHits.clear();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        Canis::OverlapIndices2DScalar(query, boxes, scalarHits);
+        auto middle = std::chrono::high_resolution_clock::now();
+        Canis::OverlapIndices2D(query, boxes, simdHits);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        scalarMs += std::chrono::duration<double, std::milli>(middle - start).count();
+        simdMs += std::chrono::duration<double, std::milli>(end - middle).count();
+        match = match && scalarHits == simdHits;
+    }
+
+    Canis::Log("overlap kernel " + std::string(Canis::GetOverlapKernelName()) + ", " + std::to_string(QUERY_COUNT) +
+               " queries against " + std::to_string(BOX_COUNT) + " boxes: scalar " + std::to_string(scalarMs) +
+               " ms, batched " + std::to_string(simdMs) + " ms, " + std::to_string(scalarMs / simdMs) + "x");
+
+    if (!match)
+        Canis::Error("overlap kernel results do not match the scalar path");
+}
+
+void RunRenderQueueBenchmark() {
+    const int COMMAND_COUNT = 100000;
+    const int SORT_COUNT = 20;
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<unsigned int> state(1, 64);
+    std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+
+    std::vector<uint64_t> keys;
+    for (int i = 0; i < COMMAND_COUNT; i++)
+        keys.push_back(Canis::RenderQueue::MakeKey(state(rng) % 4, state(rng) % 4 == 0, state(rng) % 8, state(rng), state(rng) % 16, depth(rng)));
+
+    Canis::RenderQueue queue;
+    std::vector<uint64_t> expected;
+    double radixMs = 0.0;
+    double stdMs = 0.0;
+
+    for (int pass = 0; pass < SORT_COUNT; pass++)
+    {
+        queue.Clear();
+        for (uint64_t key : keys)
+            queue.Submit(Canis::RenderCommand(), key);
+
+        expected = keys;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        queue.Sort();
+        auto middle = std::chrono::high_resolution_clock::now();
+        std::stable_sort(expected.begin(), expected.end());
+        auto end = std::chrono::high_resolution_clock::now();
+
+        radixMs += std::chrono::duration<double, std::milli>(middle - start).count();
+        stdMs += std::chrono::duration<double, std::milli>(end - middle).count();
+    }
+
+    bool match = true;
+    for (size_t i = 0; i < expected.size(); i++)
+        match = match && queue.GetKey(i) == expected[i];
+
+    Canis::Log("render queue sort " + std::to_string(COMMAND_COUNT) + " commands: radix " + std::to_string(radixMs / SORT_COUNT) +
+               " ms, std::stable_sort " + std::to_string(stdMs / SORT_COUNT) + " ms, " + std::to_string(stdMs / radixMs) + "x");
+
+    if (!match)
+        Canis::Error("render queue sort does not match std::stable_sort");
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+class World;
+
+// spawns balls in both storage modes and logs simulate + sprite submit time per frame
+// once on the calling thread alone and once spread over the world's job system
+// then churns spawns and despawns to show the entity pools settle
+// run with --benchmark, uses the world's window, input and sprite batch
+extern void RunStorageBenchmark(World &_world);
+
+// times the batched aabb overlap kernel against the one pair at a time path and checks they agree
+extern void RunOverlapBenchmark();
+
+// times the render queue radix sort against std::stable_sort on random keys and checks they agree
+extern void RunRenderQueueBenchmark();
@@ -0,0 +1,182 @@
+#pragma once
+#include <bit>
+#include <cfloat>
+#include <cstddef>
+#include <vector>
+
+#include "Data/AABB2D.hpp"
+#include "Simd.hpp"
+
+namespace Canis
+{
+    // packed structure of arrays of boxes, storage is padded to a whole block with boxes that can never
+    // overlap anything so the simd loops have no tail to handle
+    struct AABBArray2D
+    {
+        static constexpr size_t BLOCK = 8;
+
+        std::vector<float> minX = {};
+        std::vector<float> minY = {};
+        std::vector<float> maxX = {};
+        std::vector<float> maxY = {};
+        size_t count = 0;
+
+        size_t Size() const { return count; }
+        size_t PaddedSize() const { return minX.size(); }
+
+        void Set(size_t _index, const AABB2D &_box)
+        {
+            minX[_index] = _box.min.x;
+            minY[_index] = _box.min.y;
+            maxX[_index] = _box.max.x;
+            maxY[_index] = _box.max.y;
+        }
+
+        AABB2D Get(size_t _index) const
+        {
+            return {glm::vec2(minX[_index], minY[_index]), glm::vec2(maxX[_index], maxY[_index])};
+        }
+
+        void Push(const AABB2D &_box)
+        {
+            if (count == minX.size())
+                Grow(minX.size() + BLOCK);
+
+            Set(count++, _box);
+        }
+
+        // swap and pop, matches the order change of a swap and pop on a parallel array
+        void SwapRemove(size_t _index)
+        {
+            size_t last = count - 1;
+            if (_index != last)
+                Set(_index, Get(last));
+
+            SetPadding(last);
+            count--;
+        }
+
+        void Reserve(size_t _count)
+        {
+            if (_count > minX.size())
+                Grow((_count + BLOCK - 1) / BLOCK * BLOCK);
+        }
+
+        void Clear()
+        {
+            for (size_t i = 0; i < count; i++)
+                SetPadding(i);
+            count = 0;
+        }
+
+    private:
+        void SetPadding(size_t _index)
+        {
+            minX[_index] = FLT_MAX;
+            minY[_index] = FLT_MAX;
+            maxX[_index] = -FLT_MAX;
+            maxY[_index] = -FLT_MAX;
+        }
+
+        void Grow(size_t _paddedSize)
+        {
+            minX.resize(_paddedSize, FLT_MAX);
+            minY.resize(_paddedSize, FLT_MAX);
+            maxX.resize(_paddedSize, -FLT_MAX);
+            maxY.resize(_paddedSize, -FLT_MAX);
+        }
+    };
+
+    inline const char *GetOverlapKernelName()
+    {
+        return GetSimdName();
+    }
+
+    // one bit per box in the block starting at _first, _first must be a multiple of AABBArray2D::BLOCK
+    inline unsigned int OverlapBlockMask2D(const AABB2D &_box, const AABBArray2D &_array, size_t _first)
+    {
+#if defined(CANIS_SIMD_AVX2)
+        __m256 overlap = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(_box.min.x), _mm256_loadu_ps(&_array.maxX[_first]), _CMP_LE_OQ),
+                          _mm256_cmp_ps(_mm256_set1_ps(_box.max.x), _mm256_loadu_ps(&_array.minX[_first]), _CMP_GE_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(_box.min.y), _mm256_loadu_ps(&_array.maxY[_first]), _CMP_LE_OQ),
+                          _mm256_cmp_ps(_mm256_set1_ps(_box.max.y), _mm256_loadu_ps(&_array.minY[_first]), _CMP_GE_OQ)));
+
+        return (unsigned int)_mm256_movemask_ps(overlap);
+#elif defined(CANIS_SIMD_SSE)
+        __m128 boxMinX = _mm_set1_ps(_box.min.x);
+        __m128 boxMinY = _mm_set1_ps(_box.min.y);
+        __m128 boxMaxX = _mm_set1_ps(_box.max.x);
+        __m128 boxMaxY = _mm_set1_ps(_box.max.y);
+        unsigned int mask = 0;
+
+        for (size_t half = 0; half < AABBArray2D::BLOCK; half += 4)
+        {
+            size_t i = _first + half;
+            __m128 overlap = _mm_and_ps(
+                _mm_and_ps(_mm_cmple_ps(boxMinX, _mm_loadu_ps(&_array.maxX[i])), _mm_cmpge_ps(boxMaxX, _mm_loadu_ps(&_array.minX[i]))),
+                _mm_and_ps(_mm_cmple_ps(boxMinY, _mm_loadu_ps(&_array.maxY[i])), _mm_cmpge_ps(boxMaxY, _mm_loadu_ps(&_array.minY[i]))));
+
+            mask |= (unsigned int)_mm_movemask_ps(overlap) << half;
+        }
+
+        return mask;
+#else
+        unsigned int mask = 0;
+
+        for (size_t lane = 0; lane < AABBArray2D::BLOCK; lane++)
+        {
+            size_t i = _first + lane;
+            bool overlap = _box.min.x <= _array.maxX[i] && _box.max.x >= _array.minX[i] &&
+                           _box.min.y <= _array.maxY[i] && _box.max.y >= _array.minY[i];
+            mask |= (unsigned int)overlap << lane;
+        }
+
+        return mask;
+#endif
+    }
+
+    // calls _callback(index) for every box at or after _start that overlaps _box
+    template <typename F>
+    inline void ForEachOverlap2D(const AABB2D &_box, const AABBArray2D &_array, size_t _start, F &&_callback)
+    {
+        size_t first = _start - (_start % AABBArray2D::BLOCK);
+
+        for (size_t block = first; block < _array.Size(); block += AABBArray2D::BLOCK)
+        {
+            unsigned int mask = OverlapBlockMask2D(_box, _array, block);
+
+            if (block == first)
+                mask &= ~0u << (_start - first);
+
+            while (mask)
+            {
+                _callback(block + std::countr_zero(mask));
+                mask &= mask - 1;
+            }
+        }
+    }
+
+    // appends the index of every overlapping box
+    inline void OverlapIndices2D(const AABB2D &_box, const AABBArray2D &_array, std::vector<unsigned int> &_indices)
+    {
+        ForEachOverlap2D(_box, _array, 0, [&](size_t _index) { _indices.push_back(_index); });
+    }
+
+    // bit i of word i / 32 is set when box i overlaps, _mask is resized to fit
+    inline void OverlapMask2D(const AABB2D &_box, const AABBArray2D &_array, std::vector<unsigned int> &_mask)
+    {
+        _mask.assign((_array.Size() + 31) / 32, 0u);
+
+        for (size_t block = 0; block < _array.Size(); block += AABBArray2D::BLOCK)
+            _mask[block / 32] |= OverlapBlockMask2D(_box, _array, block) << (block % 32);
+    }
+
+    // reference path one pair at a time, kept for benchmarks and for checking the simd kernels
+    inline void OverlapIndices2DScalar(const AABB2D &_box, const AABBArray2D &_array, std::vector<unsigned int> &_indices)
+    {
+        for (size_t i = 0; i < _array.Size(); i++)
+            if (AABBOverlap2D(_box, _array.Get(i)))
+                _indices.push_back(i);
+    }
+} // end of Canis namespace
@@ -1,4 +1,5 @@
 #include "Canis.hpp"
+#include "JobSystem.hpp"
 #include <SDL.h>
 
 namespace Canis
@@ -6,5 +7,6 @@ namespace Canis
     void Init()
     {
         SDL_Init(SDL_INIT_EVERYTHING);
+        GetJobSystem().Start();
     }
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace Canis
+{
+	struct AABB2D
+	{
+		glm::vec2 min = glm::vec2(0.0f);
+		glm::vec2 max = glm::vec2(0.0f);
+
+		bool operator==(const AABB2D &_other) const { return min == _other.min && max == _other.max; }
+	};
+
+	inline bool AABBOverlap2D(const AABB2D &_a, const AABB2D &_b)
+	{
+		return _a.min.x <= _b.max.x && _a.max.x >= _b.min.x &&
+			   _a.min.y <= _b.max.y && _a.max.y >= _b.min.y;
+	}
+
+	// bounds of the unit quad centered on the origin once _transform is applied, z is ignored
+	inline AABB2D QuadBounds2D(const glm::mat4 &_transform)
+	{
+		glm::vec2 center = glm::vec2(_transform[3]);
+		glm::vec2 half = (glm::abs(glm::vec2(_transform[0])) + glm::abs(glm::vec2(_transform[1]))) * 0.5f;
+		return {center - half, center + half};
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace Canis
+{
+	struct BoundingSphere
+	{
+		glm::vec3 center = glm::vec3(0.0f);
+		float radius = 0.0f;
+	};
+
+	// the sphere moved by _transform, scaled by its largest axis so it still holds everything after a non uniform scale
+	inline BoundingSphere TransformSphere(const BoundingSphere &_sphere, const glm::mat4 &_transform)
+	{
+		float scale = std::max(glm::length(glm::vec3(_transform[0])),
+							   std::max(glm::length(glm::vec3(_transform[1])), glm::length(glm::vec3(_transform[2]))));
+
+		return {glm::vec3(_transform * glm::vec4(_sphere.center, 1.0f)), _sphere.radius * scale};
+	}
+
+	// around a sprite quad of _scale centered on _position, the corners are half the diagonal away
+	inline BoundingSphere SpriteBounds(const glm::vec3 &_position, const glm::vec3 &_scale)
+	{
+		return {_position, glm::length(glm::vec2(_scale.x, _scale.y)) * 0.5f};
+	}
+
+	// around the unit quad placed by _transform, the way SpriteBatch draws a cached world matrix
+	inline BoundingSphere SpriteBounds(const glm::mat4 &_transform)
+	{
+		glm::vec3 halfX = glm::vec3(_transform[0]) * 0.5f;
+		glm::vec3 halfY = glm::vec3(_transform[1]) * 0.5f;
+		return {glm::vec3(_transform[3]), std::max(glm::length(halfX + halfY), glm::length(halfX - halfY))};
+	}
+}
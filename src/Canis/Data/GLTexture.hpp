@@ -7,5 +7,6 @@ namespace Canis
 		unsigned int id;
 		int width;
 		int height;
+		unsigned int layer = 0; // slice of a TextureArray, 0 for a plain 2d texture
 	};
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include "FrameData.hpp"
+#include "GLState.hpp"
+
+#include <GL/glew.h>
+
+namespace Canis
+{
+    void FrameUniformBuffer::Init()
+    {
+        glGenBuffers(1, &m_UBO);
+
+        GLState::BindBuffer(GL_UNIFORM_BUFFER, m_UBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+
+        // the buffer stays on its binding point for the life of the context
+        GLState::BindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, m_UBO);
+    }
+
+    void FrameUniformBuffer::Update(const FrameData &_data)
+    {
+        m_data = _data;
+        m_data.viewProjection = m_data.projection * m_data.view;
+
+        GLState::BindBuffer(GL_UNIFORM_BUFFER, m_UBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &m_data);
+    }
+} // end of Canis namespace
@@ -0,0 +1,36 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace Canis
+{
+    // every shader that declares the FrameData block is attached to this binding point by Shader::Link
+    constexpr unsigned int FRAME_DATA_BINDING = 0;
+
+    // mirrors the std140 FrameData block in assets/shaders, members have to stay in the same order
+    struct FrameData
+    {
+        glm::mat4 view = glm::mat4(1.0f);
+        glm::mat4 projection = glm::mat4(1.0f);
+        glm::mat4 viewProjection = glm::mat4(1.0f); // filled in by FrameUniformBuffer::Update
+        glm::vec4 cameraPosition = glm::vec4(0.0f); // w is unused
+        glm::vec2 viewport = glm::vec2(0.0f);
+        float time = 0.0f;
+        float deltaTime = 0.0f;
+    };
+
+    static_assert(sizeof(FrameData) == 224, "FrameData has to match the std140 layout of the shader block");
+
+    // one uniform buffer written once a frame instead of every shader uploading the camera itself
+    class FrameUniformBuffer
+    {
+    public:
+        void Init();
+        void Update(const FrameData &_data);
+
+        const FrameData &GetData() const { return m_data; }
+
+    private:
+        unsigned int m_UBO = 0;
+        FrameData m_data = {};
+    };
+} // end of Canis namespace
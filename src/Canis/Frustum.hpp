@@ -0,0 +1,56 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include "Data/BoundingSphere.hpp"
+
+namespace Canis
+{
+    // six planes facing inward as (normal, distance), a point p is inside a plane when dot(normal, p) + distance >= 0
+    // a default constructed frustum has all zero planes, so it contains everything and culls nothing
+    struct Frustum
+    {
+        enum Plane
+        {
+            LEFT_PLANE,
+            RIGHT_PLANE,
+            BOTTOM_PLANE,
+            TOP_PLANE,
+            NEAR_PLANE,
+            FAR_PLANE,
+            PLANE_COUNT
+        };
+
+        glm::vec4 planes[PLANE_COUNT] = {};
+
+        // Gribb and Hartmann, each plane is the fourth row of the matrix plus or minus one of the others
+        static Frustum FromViewProjection(const glm::mat4 &_viewProjection)
+        {
+            glm::vec4 row[4];
+            for (int i = 0; i < 4; i++)
+                row[i] = glm::vec4(_viewProjection[0][i], _viewProjection[1][i], _viewProjection[2][i], _viewProjection[3][i]);
+
+            Frustum frustum;
+            frustum.planes[LEFT_PLANE] = row[3] + row[0];
+            frustum.planes[RIGHT_PLANE] = row[3] - row[0];
+            frustum.planes[BOTTOM_PLANE] = row[3] + row[1];
+            frustum.planes[TOP_PLANE] = row[3] - row[1];
+            frustum.planes[NEAR_PLANE] = row[3] + row[2];
+            frustum.planes[FAR_PLANE] = row[3] - row[2];
+
+            // normalized so the plane distance of a point is in world units and can be compared to a radius
+            for (glm::vec4 &plane : frustum.planes)
+                plane /= glm::length(glm::vec3(plane));
+
+            return frustum;
+        }
+
+        bool Contains(const BoundingSphere &_sphere) const
+        {
+            for (const glm::vec4 &plane : planes)
+                if (glm::dot(glm::vec3(plane), _sphere.center) + plane.w < -_sphere.radius)
+                    return false;
+
+            return true;
+        }
+    };
+} // end of Canis namespace
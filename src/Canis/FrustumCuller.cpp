@@ -0,0 +1,146 @@
+#include "FrustumCuller.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+
+namespace Canis
+{
+    namespace
+    {
+        // one bit per sphere in the block starting at _first, set when no plane has it fully outside
+        unsigned int VisibleBlockMask(const Frustum &_frustum, const float *_x, const float *_y, const float *_z, const float *_radius, size_t _first)
+        {
+#if defined(CANIS_SIMD_AVX2)
+            __m256 x = _mm256_loadu_ps(_x + _first);
+            __m256 y = _mm256_loadu_ps(_y + _first);
+            __m256 z = _mm256_loadu_ps(_z + _first);
+            __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(_radius + _first));
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+            for (const glm::vec4 &plane : _frustum.planes)
+            {
+                __m256 distance = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane.x)), _mm256_mul_ps(y, _mm256_set1_ps(plane.y))),
+                    _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+            }
+
+            return (unsigned int)_mm256_movemask_ps(inside);
+#elif defined(CANIS_SIMD_SSE)
+            unsigned int mask = 0;
+
+            for (size_t half = 0; half < FrustumCuller::BLOCK; half += 4)
+            {
+                size_t i = _first + half;
+                __m128 x = _mm_loadu_ps(_x + i);
+                __m128 y = _mm_loadu_ps(_y + i);
+                __m128 z = _mm_loadu_ps(_z + i);
+                __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(_radius + i));
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+                for (const glm::vec4 &plane : _frustum.planes)
+                {
+                    __m128 distance = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+                        _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+                }
+
+                mask |= (unsigned int)_mm_movemask_ps(inside) << half;
+            }
+
+            return mask;
+#else
+            unsigned int mask = 0;
+
+            for (size_t lane = 0; lane < FrustumCuller::BLOCK; lane++)
+            {
+                size_t i = _first + lane;
+                bool inside = true;
+
+                for (const glm::vec4 &plane : _frustum.planes)
+                    inside = inside && plane.x * _x[i] + plane.y * _y[i] + plane.z * _z[i] + plane.w >= -_radius[i];
+
+                mask |= (unsigned int)inside << lane;
+            }
+
+            return mask;
+#endif
+        }
+    }
+
+    void FrustumCuller::Clear()
+    {
+        // padding has a radius no plane distance can reach, so it is never visible
+        for (size_t i = 0; i < m_count; i++)
+            m_radius[i] = -FLT_MAX;
+
+        m_count = 0;
+    }
+
+    void FrustumCuller::Reserve(size_t _count)
+    {
+        size_t paddedSize = (_count + BLOCK - 1) / BLOCK * BLOCK;
+        if (paddedSize <= m_radius.size())
+            return;
+
+        m_centerX.resize(paddedSize, 0.0f);
+        m_centerY.resize(paddedSize, 0.0f);
+        m_centerZ.resize(paddedSize, 0.0f);
+        m_radius.resize(paddedSize, -FLT_MAX);
+    }
+
+    size_t FrustumCuller::Add(const BoundingSphere &_sphere)
+    {
+        if (m_count == m_radius.size())
+            Reserve(m_radius.size() * 2 + BLOCK);
+
+        m_centerX[m_count] = _sphere.center.x;
+        m_centerY[m_count] = _sphere.center.y;
+        m_centerZ[m_count] = _sphere.center.z;
+        m_radius[m_count] = _sphere.radius;
+
+        return m_count++;
+    }
+
+    void FrustumCuller::Cull(const Frustum &_frustum, JobSystem *_jobSystem)
+    {
+        m_visible.assign((m_count + 31) / 32, 0u);
+
+        size_t blockCount = (m_count + BLOCK - 1) / BLOCK;
+
+        if (_jobSystem != nullptr && m_count >= PARALLEL_THRESHOLD)
+        {
+            // ranges of whole mask words so no two jobs write to the same word
+            const size_t blocksPerWord = 32 / BLOCK;
+            size_t wordCount = m_visible.size();
+
+            _jobSystem->ParallelFor(wordCount, 0, [&](size_t _begin, size_t _end) {
+                CullBlocks(_frustum, _begin * blocksPerWord, std::min(_end * blocksPerWord, blockCount));
+            });
+        }
+        else
+        {
+            CullBlocks(_frustum, 0, blockCount);
+        }
+
+        m_stats.visible = 0;
+        for (unsigned int word : m_visible)
+            m_stats.visible += std::popcount(word);
+
+        m_stats.culled = m_count - m_stats.visible;
+    }
+
+    void FrustumCuller::CullBlocks(const Frustum &_frustum, size_t _begin, size_t _end)
+    {
+        for (size_t block = _begin; block < _end; block++)
+        {
+            size_t first = block * BLOCK;
+            m_visible[first / 32] |= VisibleBlockMask(_frustum, m_centerX.data(), m_centerY.data(), m_centerZ.data(), m_radius.data(), first) << (first % 32);
+        }
+    }
+} // end of Canis namespace
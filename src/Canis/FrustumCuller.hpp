@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "Frustum.hpp"
+#include "JobSystem.hpp"
+
+namespace Canis
+{
+    struct CullStats
+    {
+        unsigned int visible = 0;
+        unsigned int culled = 0;
+    };
+
+    // bounding spheres for one frame stored as a padded structure of arrays, Cull tests a whole block
+    // against every plane at once and leaves one visibility bit per sphere
+    class FrustumCuller
+    {
+    public:
+        static constexpr size_t BLOCK = 8;
+        // below this many spheres a parallel cull costs more than it saves
+        static constexpr size_t PARALLEL_THRESHOLD = 4096;
+
+        // forgets the spheres but keeps the storage for the next frame
+        void Clear();
+        void Reserve(size_t _count);
+        // returns the index IsVisible takes after Cull
+        size_t Add(const BoundingSphere &_sphere);
+
+        // spread across _jobSystem when it is set and there are enough spheres
+        void Cull(const Frustum &_frustum, JobSystem *_jobSystem = nullptr);
+
+        bool IsVisible(size_t _index) const { return (m_visible[_index / 32] >> (_index % 32)) & 1u; }
+        size_t Size() const { return m_count; }
+        CullStats GetStats() const { return m_stats; }
+
+    private:
+        void CullBlocks(const Frustum &_frustum, size_t _begin, size_t _end);
+
+        std::vector<float> m_centerX = {};
+        std::vector<float> m_centerY = {};
+        std::vector<float> m_centerZ = {};
+        std::vector<float> m_radius = {};
+        std::vector<unsigned int> m_visible = {};
+        size_t m_count = 0;
+        CullStats m_stats = {};
+    };
+} // end of Canis namespace
@@ -0,0 +1,218 @@
+#include "GLState.hpp"
+
+#include <GL/glew.h>
+
+namespace Canis
+{
+    namespace
+    {
+        const unsigned int UNKNOWN = ~0u;
+        const unsigned int MAX_TEXTURE_UNITS = 32;
+
+        enum TextureSlot
+        {
+            SLOT_2D,
+            SLOT_2D_ARRAY,
+            SLOT_CUBE_MAP,
+            SLOT_COUNT
+        };
+
+        struct Cache
+        {
+            unsigned int program = UNKNOWN;
+            unsigned int vertexArray = UNKNOWN;
+            unsigned int arrayBuffer = UNKNOWN;
+            unsigned int elementBuffer = UNKNOWN;
+            unsigned int uniformBuffer = UNKNOWN;
+            unsigned int pixelPackBuffer = UNKNOWN;
+            unsigned int activeUnit = UNKNOWN;
+            unsigned int textures[MAX_TEXTURE_UNITS][SLOT_COUNT];
+            unsigned int blend = UNKNOWN;
+            unsigned int blendSource = UNKNOWN;
+            unsigned int blendDestination = UNKNOWN;
+
+            Cache()
+            {
+                for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+                    for (unsigned int slot = 0; slot < SLOT_COUNT; slot++)
+                        textures[unit][slot] = UNKNOWN;
+            }
+        };
+
+        Cache g_cache;
+        GLStateStats g_stats;
+
+        // true when the call has to be made, the cached value is updated either way
+        bool Change(unsigned int &_cached, unsigned int _value)
+        {
+            if (_cached == _value)
+            {
+                g_stats.skipped++;
+                return false;
+            }
+
+            _cached = _value;
+            g_stats.issued++;
+            return true;
+        }
+
+        unsigned int *BufferSlot(unsigned int _target)
+        {
+            switch (_target)
+            {
+            case GL_ARRAY_BUFFER:
+                return &g_cache.arrayBuffer;
+            case GL_ELEMENT_ARRAY_BUFFER:
+                return &g_cache.elementBuffer;
+            case GL_UNIFORM_BUFFER:
+                return &g_cache.uniformBuffer;
+            case GL_PIXEL_PACK_BUFFER:
+                return &g_cache.pixelPackBuffer;
+            default:
+                return nullptr;
+            }
+        }
+
+        int TextureSlotFor(unsigned int _target)
+        {
+            switch (_target)
+            {
+            case GL_TEXTURE_2D:
+                return SLOT_2D;
+            case GL_TEXTURE_2D_ARRAY:
+                return SLOT_2D_ARRAY;
+            case GL_TEXTURE_CUBE_MAP:
+                return SLOT_CUBE_MAP;
+            default:
+                return -1;
+            }
+        }
+    }
+
+    void GLState::UseProgram(unsigned int _program)
+    {
+        if (Change(g_cache.program, _program))
+            glUseProgram(_program);
+    }
+
+    void GLState::BindVertexArray(unsigned int _vao)
+    {
+        if (Change(g_cache.vertexArray, _vao))
+        {
+            glBindVertexArray(_vao);
+            g_cache.elementBuffer = UNKNOWN;
+        }
+    }
+
+    void GLState::BindBuffer(unsigned int _target, unsigned int _buffer)
+    {
+        unsigned int *cached = BufferSlot(_target);
+
+        if (cached == nullptr)
+        {
+            g_stats.issued++;
+            glBindBuffer(_target, _buffer);
+            return;
+        }
+
+        if (Change(*cached, _buffer))
+            glBindBuffer(_target, _buffer);
+    }
+
+    void GLState::BindBufferBase(unsigned int _target, unsigned int _index, unsigned int _buffer)
+    {
+        g_stats.issued++;
+        glBindBufferBase(_target, _index, _buffer);
+
+        unsigned int *cached = BufferSlot(_target);
+        if (cached != nullptr)
+            *cached = _buffer;
+    }
+
+    void GLState::ActiveTexture(unsigned int _unit)
+    {
+        if (Change(g_cache.activeUnit, _unit))
+            glActiveTexture(GL_TEXTURE0 + _unit);
+    }
+
+    void GLState::BindTexture(unsigned int _target, unsigned int _texture)
+    {
+        int slot = TextureSlotFor(_target);
+
+        if (slot < 0)
+        {
+            g_stats.issued++;
+            glBindTexture(_target, _texture);
+            return;
+        }
+
+        // without knowing the unit any of them could have changed
+        if (g_cache.activeUnit >= MAX_TEXTURE_UNITS)
+        {
+            for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+                g_cache.textures[unit][slot] = UNKNOWN;
+
+            g_stats.issued++;
+            glBindTexture(_target, _texture);
+            return;
+        }
+
+        if (Change(g_cache.textures[g_cache.activeUnit][slot], _texture))
+            glBindTexture(_target, _texture);
+    }
+
+    void GLState::BindTexture(unsigned int _unit, unsigned int _target, unsigned int _texture)
+    {
+        int slot = TextureSlotFor(_target);
+
+        // a bind that would be skipped does not need the unit switched either
+        if (slot >= 0 && _unit < MAX_TEXTURE_UNITS && g_cache.textures[_unit][slot] == _texture)
+        {
+            g_stats.skipped++;
+            return;
+        }
+
+        ActiveTexture(_unit);
+        BindTexture(_target, _texture);
+    }
+
+    void GLState::SetBlend(bool _enabled)
+    {
+        if (!Change(g_cache.blend, _enabled))
+            return;
+
+        if (_enabled)
+            glEnable(GL_BLEND);
+        else
+            glDisable(GL_BLEND);
+    }
+
+    void GLState::BlendFunc(unsigned int _source, unsigned int _destination)
+    {
+        if (g_cache.blendSource == _source && g_cache.blendDestination == _destination)
+        {
+            g_stats.skipped++;
+            return;
+        }
+
+        g_cache.blendSource = _source;
+        g_cache.blendDestination = _destination;
+        g_stats.issued++;
+        glBlendFunc(_source, _destination);
+    }
+
+    void GLState::Invalidate()
+    {
+        g_cache = Cache();
+    }
+
+    GLStateStats GLState::GetStats()
+    {
+        return g_stats;
+    }
+
+    void GLState::ResetStats()
+    {
+        g_stats = GLStateStats();
+    }
+} // end of Canis namespace
@@ -0,0 +1,34 @@
+#pragma once
+
+namespace Canis
+{
+    struct GLStateStats
+    {
+        unsigned int issued = 0;
+        unsigned int skipped = 0;
+    };
+
+    // shadow copy of the bindings we change most, a call that would set what is already bound is skipped
+    // every bind in the engine has to go through here or the copy goes stale, call Invalidate after
+    // handing the context to code that does not, like imgui, or after deleting a bound object
+    class GLState
+    {
+    public:
+        static void UseProgram(unsigned int _program);
+        static void BindVertexArray(unsigned int _vao);
+        // the element array binding belongs to the vao so it is forgotten whenever the vao changes
+        static void BindBuffer(unsigned int _target, unsigned int _buffer);
+        // binds an indexed target like a uniform block slot, gl also changes the plain _target binding
+        static void BindBufferBase(unsigned int _target, unsigned int _index, unsigned int _buffer);
+        static void ActiveTexture(unsigned int _unit); // 0 based, not GL_TEXTURE0 + unit
+        static void BindTexture(unsigned int _target, unsigned int _texture);
+        static void BindTexture(unsigned int _unit, unsigned int _target, unsigned int _texture);
+        static void SetBlend(bool _enabled);
+        static void BlendFunc(unsigned int _source, unsigned int _destination);
+
+        static void Invalidate();
+
+        static GLStateStats GetStats();
+        static void ResetStats();
+    };
+} // end of Canis namespace
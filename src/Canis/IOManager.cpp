@@ -1,5 +1,6 @@
 #include "IOManager.hpp"
 #include "Debug.hpp"
+#include "GLState.hpp"
 
 #include <SDL.h>
 #include <GL/glew.h>
@@ -20,7 +21,7 @@ namespace Canis
 		int nrChannels;
 
 		glGenTextures(1, &texture.id);
-		glBindTexture(GL_TEXTURE_2D, texture.id);
+		GLState::BindTexture(GL_TEXTURE_2D, texture.id);
 
 		stbi_set_flip_vertically_on_load(true);
 		SDL_RWops *file = SDL_RWFromFile(_path.c_str(), "rb");
@@ -65,20 +66,49 @@ namespace Canis
 
 		glGenerateMipmap(GL_TEXTURE_2D);
 
-		glBindTexture(GL_TEXTURE_2D, 0);
+		GLState::BindTexture(GL_TEXTURE_2D, 0);
 
 		stbi_set_flip_vertically_on_load(true);
 
 		return texture;
 	}
 
+	bool LoadImagePixels(std::string _path, int &_width, int &_height, std::vector<unsigned char> &_pixels)
+	{
+		size_t fileSize = 0;
+		void *fileData = SDL_LoadFile(_path.c_str(), &fileSize);
+
+		if (fileData == nullptr)
+		{
+			Error("Failed to open file at path : " + _path);
+			return false;
+		}
+
+		stbi_set_flip_vertically_on_load(true);
+
+		int nrChannels;
+		stbi_uc *data = stbi_load_from_memory(static_cast<stbi_uc *>(fileData), static_cast<int>(fileSize), &_width, &_height, &nrChannels, 4);
+		SDL_free(fileData);
+
+		if (data == nullptr)
+		{
+			Error("Failed to load texture " + _path);
+			return false;
+		}
+
+		_pixels.assign(data, data + _width * _height * 4);
+		stbi_image_free(data);
+
+		return true;
+	}
+
 	unsigned int LoadImageToCubemap(std::vector<std::string> _faces, int _sourceFormat)
 	{
 		stbi_set_flip_vertically_on_load(false);
 
 		unsigned int textureID;
 		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+		GLState::BindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
 		int width, height, nrChannels;
 
@@ -10,6 +10,9 @@ namespace Canis
 
     extern GLTexture LoadImageGL(std::string _path, int _sourceFormat, int _format, bool _wrap);
 
+    // decodes to rgba on the cpu, bottom row first like LoadImageGL, for building atlases and texture arrays
+    extern bool LoadImagePixels(std::string _path, int &_width, int &_height, std::vector<unsigned char> &_pixels);
+
     extern unsigned int LoadImageToCubemap(std::vector<std::string> _faces, int _sourceFormat);
 
     extern bool LoadOBJ(std::string _path,
@@ -3,6 +3,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "InputSource.hpp"
+
 namespace Canis
 {
     enum class InputDevice
@@ -53,7 +55,7 @@ namespace Canis
         unsigned int key;
         bool value;
     };
-    class InputManager
+    class InputManager : public InputSource
     {
     public:
         InputManager();
@@ -61,7 +63,7 @@ namespace Canis
 
         bool Update(int _screenWidth, int _screenHeight);
 
-        bool GetKey(unsigned int _keyID);
+        bool GetKey(unsigned int _keyID) override;
         bool JustPressedKey(unsigned int _keyID);
         bool JustReleasedKey(unsigned int _keyID);
         
@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+
+namespace Canis
+{
+    // what gameplay code reads input through, InputManager reads the keyboard while a headless world
+    // can be driven by a ScriptedInput filled in by a bot or a replay
+    class InputSource
+    {
+    public:
+        virtual ~InputSource() {}
+
+        virtual bool GetKey(unsigned int _keyID) = 0;
+    };
+
+    // keys are held until released, nothing here touches SDL
+    class ScriptedInput : public InputSource
+    {
+    public:
+        void SetKey(unsigned int _keyID, bool _down)
+        {
+            if (_keyID >= m_keys.size())
+                m_keys.resize(_keyID + 1, false);
+
+            m_keys[_keyID] = _down;
+        }
+
+        void ReleaseAll() { m_keys.assign(m_keys.size(), false); }
+
+        bool GetKey(unsigned int _keyID) override { return _keyID < m_keys.size() && m_keys[_keyID]; }
+
+    private:
+        std::vector<bool> m_keys = {};
+    };
+} // end of Canis namespace
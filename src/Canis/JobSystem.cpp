@@ -0,0 +1,231 @@
+#include "JobSystem.hpp"
+#include "Debug.hpp"
+
+namespace Canis
+{
+    namespace
+    {
+        // which job system the current thread works for and which queue it owns
+        thread_local JobSystem *t_owner = nullptr;
+        thread_local unsigned int t_workerIndex = 0;
+    }
+
+    JobSystem::~JobSystem()
+    {
+        Stop();
+    }
+
+    void JobSystem::Start(unsigned int _workerCount)
+    {
+        if (m_running)
+        {
+            Warning("JobSystem is already running");
+            return;
+        }
+
+        if (_workerCount == 0)
+        {
+            unsigned int hardwareThreads = std::thread::hardware_concurrency();
+            _workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        m_queues.clear();
+        for (unsigned int i = 0; i <= _workerCount; i++)
+            m_queues.push_back(std::make_unique<WorkQueue>());
+
+        m_queuedJobs = 0;
+        m_running = true;
+
+        for (unsigned int i = 0; i < _workerCount; i++)
+            m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+
+        Log("JobSystem started " + std::to_string(_workerCount) + " workers");
+    }
+
+    void JobSystem::Stop()
+    {
+        if (!m_running)
+            return;
+
+        {
+            std::lock_guard<std::mutex> guard(m_sleepLock);
+            m_running = false;
+        }
+        m_wake.notify_all();
+
+        for (std::thread &worker : m_workers)
+            worker.join();
+
+        m_workers.clear();
+
+        // nothing is left to pick up work, so anything still queued runs here
+        for (unsigned int i = 0; i < m_queues.size(); i++)
+            while (TryRunOne(i)) {}
+    }
+
+    void JobSystem::Run(Job _job, JobCounter *_counter)
+    {
+        if (_counter != nullptr)
+            _counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+        if (!m_running)
+        {
+            _job();
+            Finish(_counter);
+            return;
+        }
+
+        Push([this, job = std::move(_job), _counter]() {
+            job();
+            Finish(_counter);
+        });
+    }
+
+    void JobSystem::RunAfter(JobCounter &_dependency, Job _job, JobCounter *_counter)
+    {
+        if (_counter != nullptr)
+            _counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+        Job wrapped = [this, job = std::move(_job), _counter]() {
+            job();
+            Finish(_counter);
+        };
+
+        {
+            // Finish takes the same lock, so the dependency can not complete between the check and the append
+            std::lock_guard<std::mutex> guard(_dependency.lock);
+
+            if (!_dependency.Done())
+            {
+                _dependency.continuations.push_back(std::move(wrapped));
+                return;
+            }
+        }
+
+        if (m_running)
+            Push(std::move(wrapped));
+        else
+            wrapped();
+    }
+
+    void JobSystem::Wait(JobCounter &_counter)
+    {
+        unsigned int home = HomeQueue();
+
+        while (!_counter.Done())
+        {
+            if (!m_running || !TryRunOne(home))
+                std::this_thread::yield();
+        }
+
+        // the last Finish may still hold the lock, it is released before _counter can go away
+        std::lock_guard<std::mutex> guard(_counter.lock);
+    }
+
+    void JobSystem::Push(Job _job)
+    {
+        WorkQueue &queue = *m_queues[HomeQueue()];
+
+        {
+            std::lock_guard<std::mutex> guard(queue.lock);
+            queue.jobs.push_back(std::move(_job));
+        }
+
+        m_queuedJobs.fetch_add(1, std::memory_order_release);
+
+        // taking the lock stops a worker missing the wake between checking for work and sleeping
+        {
+            std::lock_guard<std::mutex> guard(m_sleepLock);
+        }
+        m_wake.notify_one();
+    }
+
+    bool JobSystem::TryRunOne(unsigned int _home)
+    {
+        Job job;
+
+        // newest work from our own queue first
+        {
+            WorkQueue &queue = *m_queues[_home];
+            std::lock_guard<std::mutex> guard(queue.lock);
+
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+            }
+        }
+
+        // then steal the oldest work from everyone else
+        for (unsigned int i = 1; !job && i < m_queues.size(); i++)
+        {
+            WorkQueue &queue = *m_queues[(_home + i) % m_queues.size()];
+            std::lock_guard<std::mutex> guard(queue.lock);
+
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+            }
+        }
+
+        if (!job)
+            return false;
+
+        m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        job();
+        return true;
+    }
+
+    void JobSystem::WorkerLoop(unsigned int _index)
+    {
+        t_owner = this;
+        t_workerIndex = _index;
+
+        while (m_running)
+        {
+            if (TryRunOne(_index))
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_sleepLock);
+            m_wake.wait(lock, [this]() { return m_queuedJobs.load(std::memory_order_acquire) > 0 || !m_running; });
+        }
+    }
+
+    void JobSystem::Finish(JobCounter *_counter)
+    {
+        if (_counter == nullptr)
+            return;
+
+        std::vector<Job> ready;
+
+        {
+            std::lock_guard<std::mutex> guard(_counter->lock);
+
+            if (_counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ready.swap(_counter->continuations);
+        }
+
+        for (Job &job : ready)
+        {
+            if (m_running)
+                Push(std::move(job));
+            else
+                job();
+        }
+    }
+
+    unsigned int JobSystem::HomeQueue() const
+    {
+        if (t_owner == this)
+            return t_workerIndex;
+
+        return m_queues.size() - 1;
+    }
+
+    JobSystem &GetJobSystem()
+    {
+        static JobSystem jobSystem;
+        return jobSystem;
+    }
+} // end of Canis namespace
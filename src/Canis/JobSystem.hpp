@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Canis
+{
+    using Job = std::function<void()>;
+
+    // counts jobs that have not finished yet, jobs queued with RunAfter start once it reaches zero
+    struct JobCounter
+    {
+        std::atomic<int> pending = 0;
+        std::mutex lock;
+        std::vector<Job> continuations = {};
+
+        bool Done() const { return pending.load(std::memory_order_acquire) == 0; }
+    };
+
+    // each worker owns a deque, it pops new work from the back and idle workers steal the oldest
+    // work from the front of the others so big jobs spread out while small ones stay cache warm
+    // threads that are not workers push into one shared queue and help out while they Wait
+    class JobSystem
+    {
+    public:
+        ~JobSystem();
+
+        // 0 starts one worker per hardware thread, minus the thread calling Start
+        void Start(unsigned int _workerCount = 0);
+        void Stop();
+
+        bool IsRunning() const { return m_running; }
+        unsigned int GetWorkerCount() const { return m_workers.size(); }
+
+        // before Start or after Stop the job runs right away on the calling thread
+        void Run(Job _job, JobCounter *_counter = nullptr);
+        // _job is queued once _dependency reaches zero, _counter covers it from now on
+        void RunAfter(JobCounter &_dependency, Job _job, JobCounter *_counter = nullptr);
+        // runs queued jobs on the calling thread until _counter reaches zero
+        void Wait(JobCounter &_counter);
+
+        // calls _body(begin, end) over [0, _count) in ranges of _grainSize and returns when all are done
+        // a _grainSize of 0 picks a few ranges per thread
+        template <typename F>
+        void ParallelFor(size_t _count, size_t _grainSize, F &&_body)
+        {
+            if (_count == 0)
+                return;
+
+            if (_grainSize == 0)
+                _grainSize = std::max<size_t>(1, _count / ((GetWorkerCount() + 1) * 4));
+
+            JobCounter counter;
+
+            for (size_t begin = _grainSize; begin < _count; begin += _grainSize)
+            {
+                size_t end = std::min(begin + _grainSize, _count);
+                Run([&_body, begin, end]() { _body(begin, end); }, &counter);
+            }
+
+            // the calling thread takes the first range instead of sitting idle
+            _body(0, std::min(_grainSize, _count));
+            Wait(counter);
+        }
+
+    private:
+        struct WorkQueue
+        {
+            std::mutex lock;
+            std::deque<Job> jobs = {};
+        };
+
+        // one per worker, the last one is shared by every other thread
+        std::vector<std::unique_ptr<WorkQueue>> m_queues = {};
+        std::vector<std::thread> m_workers = {};
+
+        std::atomic<int> m_queuedJobs = 0;
+        std::atomic<bool> m_running = false;
+        std::mutex m_sleepLock;
+        std::condition_variable m_wake;
+
+        void Push(Job _job);
+        bool TryRunOne(unsigned int _home);
+        void WorkerLoop(unsigned int _index);
+        void Finish(JobCounter *_counter);
+        unsigned int HomeQueue() const;
+    };
+
+    // the engine wide job system, started by Canis::Init
+    extern JobSystem &GetJobSystem();
+} // end of Canis namespace
@@ -0,0 +1,565 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace Canis
+{
+    namespace
+    {
+        template <size_t N>
+        struct FloatKey
+        {
+            float values[N];
+
+            bool operator==(const FloatKey &_other) const
+            {
+                return memcmp(values, _other.values, sizeof(values)) == 0;
+            }
+        };
+
+        using VertexKey = FloatKey<MODEL_VERTEX_FLOATS>;
+        using PositionKey = FloatKey<3>;
+
+        // FNV-1a over the bytes, the same corner always has the same bits since it comes from the same obj line
+        struct FloatKeyHash
+        {
+            template <size_t N>
+            size_t operator()(const FloatKey<N> &_key) const
+            {
+                const unsigned char *bytes = (const unsigned char *)_key.values;
+                size_t hash = 2166136261u;
+                for (size_t i = 0; i < sizeof(_key.values); i++)
+                {
+                    hash ^= bytes[i];
+                    hash *= 16777619u;
+                }
+                return hash;
+            }
+        };
+
+        // scoring from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+        const int CACHE_SIZE = 32;
+        const float CACHE_DECAY_POWER = 1.5f;
+        const float LAST_TRIANGLE_SCORE = 0.75f;
+        const float VALENCE_BOOST_SCALE = 2.0f;
+        const float VALENCE_BOOST_POWER = 0.5f;
+
+        float VertexScore(int _cachePosition, int _remainingTriangles)
+        {
+            // nothing left to draw with this vertex, it should not pull any triangle forward
+            if (_remainingTriangles == 0)
+                return -1.0f;
+
+            float score = 0.0f;
+
+            if (_cachePosition >= 0)
+            {
+                // the last triangle's three vertices score the same so it does not matter which one is reused
+                if (_cachePosition < 3)
+                    score = LAST_TRIANGLE_SCORE;
+                else
+                    score = std::pow(1.0f - (float)(_cachePosition - 3) / (CACHE_SIZE - 3), CACHE_DECAY_POWER);
+            }
+
+            // vertices with few triangles left are finished off first so they can leave the cache
+            score += VALENCE_BOOST_SCALE * std::pow((float)_remainingTriangles, -VALENCE_BOOST_POWER);
+
+            return score;
+        }
+
+        // symmetric 4x4 matrix summing squared distances to planes, kept with the weight it was built from
+        // so the error can be read as an average distance instead of growing with the triangle count
+        struct Quadric
+        {
+            double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+            double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+            double a22 = 0.0, a23 = 0.0;
+            double a33 = 0.0;
+            double weight = 0.0;
+
+            void AddPlane(const glm::vec3 &_normal, float _distance, float _weight)
+            {
+                double x = _normal.x, y = _normal.y, z = _normal.z, d = _distance;
+                a00 += _weight * x * x; a01 += _weight * x * y; a02 += _weight * x * z; a03 += _weight * x * d;
+                a11 += _weight * y * y; a12 += _weight * y * z; a13 += _weight * y * d;
+                a22 += _weight * z * z; a23 += _weight * z * d;
+                a33 += _weight * d * d;
+                weight += _weight;
+            }
+
+            void Add(const Quadric &_other)
+            {
+                a00 += _other.a00; a01 += _other.a01; a02 += _other.a02; a03 += _other.a03;
+                a11 += _other.a11; a12 += _other.a12; a13 += _other.a13;
+                a22 += _other.a22; a23 += _other.a23;
+                a33 += _other.a33;
+                weight += _other.weight;
+            }
+
+            // squared distance to the planes at _point
+            double Error(const glm::vec3 &_point) const
+            {
+                double x = _point.x, y = _point.y, z = _point.z;
+                double error = a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x
+                             + a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y
+                             + a22 * z * z + 2.0 * a23 * z
+                             + a33;
+                return std::max(error, 0.0);
+            }
+        };
+
+        struct Collapse
+        {
+            unsigned int from;
+            unsigned int to;
+            double error;
+        };
+
+        // below this cosine between a triangle's normal before and after a collapse it counts as flipped
+        const float FLIP_COSINE = 0.25f;
+    }
+
+    void BuildIndexedMesh(const std::vector<glm::vec3> &_positions,
+                          const std::vector<glm::vec2> &_uvs,
+                          const std::vector<glm::vec3> &_normals,
+                          std::vector<float> &_vertices,
+                          std::vector<unsigned int> &_indices)
+    {
+        std::unordered_map<VertexKey, unsigned int, FloatKeyHash> lookup;
+        lookup.reserve(_positions.size());
+
+        _vertices.clear();
+        _indices.clear();
+        _indices.reserve(_positions.size());
+
+        for (size_t i = 0; i < _positions.size(); i++)
+        {
+            VertexKey key = {{
+                _positions[i].x, _positions[i].y, _positions[i].z,
+                _normals[i].x, _normals[i].y, _normals[i].z,
+                _uvs[i].x, _uvs[i].y}};
+
+            auto it = lookup.find(key);
+            if (it != lookup.end())
+            {
+                _indices.push_back(it->second);
+                continue;
+            }
+
+            unsigned int index = _vertices.size() / MODEL_VERTEX_FLOATS;
+            lookup.emplace(key, index);
+            _vertices.insert(_vertices.end(), key.values, key.values + MODEL_VERTEX_FLOATS);
+            _indices.push_back(index);
+        }
+    }
+
+    void OptimizeVertexCache(std::vector<unsigned int> &_indices, unsigned int _vertexCount)
+    {
+        size_t triangleCount = _indices.size() / 3;
+        if (triangleCount == 0)
+            return;
+
+        // every vertex's triangles as one flat list, vertex v owns [triangleStart[v], triangleStart[v + 1])
+        std::vector<unsigned int> triangleStart(_vertexCount + 1, 0);
+        for (unsigned int index : _indices)
+            triangleStart[index + 1]++;
+        for (unsigned int v = 0; v < _vertexCount; v++)
+            triangleStart[v + 1] += triangleStart[v];
+
+        std::vector<unsigned int> vertexTriangles(_indices.size());
+        std::vector<unsigned int> remaining(_vertexCount, 0); // triangles of the vertex not drawn yet
+        for (size_t i = 0; i < _indices.size(); i++)
+        {
+            unsigned int v = _indices[i];
+            vertexTriangles[triangleStart[v] + remaining[v]++] = i / 3;
+        }
+
+        std::vector<int> cachePosition(_vertexCount, -1);
+        std::vector<float> vertexScore(_vertexCount);
+        for (unsigned int v = 0; v < _vertexCount; v++)
+            vertexScore[v] = VertexScore(-1, remaining[v]);
+
+        std::vector<float> triangleScore(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+        for (size_t t = 0; t < triangleCount; t++)
+            triangleScore[t] = vertexScore[_indices[t * 3]] + vertexScore[_indices[t * 3 + 1]] + vertexScore[_indices[t * 3 + 2]];
+
+        // room for the new triangle's vertices before the oldest ones are pushed out
+        std::vector<unsigned int> cache;
+        std::vector<unsigned int> nextCache;
+        cache.reserve(CACHE_SIZE + 3);
+        nextCache.reserve(CACHE_SIZE + 3);
+
+        std::vector<unsigned int> output;
+        output.reserve(_indices.size());
+
+        size_t scanStart = 0;
+        long bestTriangle = -1;
+
+        for (size_t drawn = 0; drawn < triangleCount; drawn++)
+        {
+            // the cache had nothing left to offer, fall back to the best triangle anywhere
+            if (bestTriangle < 0)
+            {
+                float bestScore = -1.0f;
+
+                while (scanStart < triangleCount && emitted[scanStart])
+                    scanStart++;
+
+                for (size_t t = scanStart; t < triangleCount; t++)
+                {
+                    if (!emitted[t] && triangleScore[t] > bestScore)
+                    {
+                        bestScore = triangleScore[t];
+                        bestTriangle = t;
+                    }
+                }
+            }
+
+            unsigned int *corners = &_indices[bestTriangle * 3];
+            output.insert(output.end(), corners, corners + 3);
+            emitted[bestTriangle] = true;
+
+            // the triangle's vertices go to the front of the lru cache and lose this triangle from their list
+            nextCache.clear();
+            for (int corner = 0; corner < 3; corner++)
+            {
+                unsigned int v = corners[corner];
+
+                // a degenerate triangle lists the same vertex twice, it was handled by the first corner
+                if (std::find(nextCache.begin(), nextCache.end(), v) != nextCache.end())
+                    continue;
+
+                nextCache.push_back(v);
+
+                unsigned int *begin = &vertexTriangles[triangleStart[v]];
+                unsigned int *end = begin + remaining[v];
+                end = std::remove(begin, end, (unsigned int)bestTriangle);
+                remaining[v] = end - begin;
+            }
+
+            for (unsigned int v : cache)
+                if (v != corners[0] && v != corners[1] && v != corners[2])
+                    nextCache.push_back(v);
+
+            for (size_t i = 0; i < nextCache.size(); i++)
+            {
+                unsigned int v = nextCache[i];
+                cachePosition[v] = i < (size_t)CACHE_SIZE ? (int)i : -1;
+                vertexScore[v] = VertexScore(cachePosition[v], remaining[v]);
+            }
+
+            if (nextCache.size() > (size_t)CACHE_SIZE)
+                nextCache.resize(CACHE_SIZE);
+
+            cache.swap(nextCache);
+
+            // only triangles touching the cache changed score, the best of them is drawn next
+            bestTriangle = -1;
+            float bestScore = -1.0f;
+
+            for (unsigned int v : cache)
+            {
+                for (unsigned int i = 0; i < remaining[v]; i++)
+                {
+                    unsigned int t = vertexTriangles[triangleStart[v] + i];
+                    const unsigned int *tri = &_indices[t * 3];
+                    triangleScore[t] = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+
+                    if (triangleScore[t] > bestScore)
+                    {
+                        bestScore = triangleScore[t];
+                        bestTriangle = t;
+                    }
+                }
+            }
+        }
+
+        _indices.swap(output);
+    }
+
+    float SimplifyMesh(const std::vector<float> &_vertices, std::vector<unsigned int> &_indices, size_t _targetIndexCount)
+    {
+        unsigned int vertexCount = _vertices.size() / MODEL_VERTEX_FLOATS;
+
+        // the simplifier works on positions, vertices split by a normal or uv seam move together
+        std::unordered_map<PositionKey, unsigned int, FloatKeyHash> lookup;
+        std::vector<unsigned int> positionOf(vertexCount);
+        std::vector<glm::vec3> points;
+
+        for (unsigned int v = 0; v < vertexCount; v++)
+        {
+            const float *source = &_vertices[v * MODEL_VERTEX_FLOATS];
+            auto it = lookup.emplace(PositionKey{{source[0], source[1], source[2]}}, (unsigned int)points.size()).first;
+            if (it->second == points.size())
+                points.push_back(glm::vec3(source[0], source[1], source[2]));
+            positionOf[v] = it->second;
+        }
+
+        unsigned int pointCount = points.size();
+
+        // vertices sharing a position, point p owns [wedgeStart[p], wedgeStart[p + 1])
+        std::vector<unsigned int> wedgeStart(pointCount + 1, 0);
+        for (unsigned int v = 0; v < vertexCount; v++)
+            wedgeStart[positionOf[v] + 1]++;
+        for (unsigned int p = 0; p < pointCount; p++)
+            wedgeStart[p + 1] += wedgeStart[p];
+
+        std::vector<unsigned int> wedges(vertexCount);
+        std::vector<unsigned int> wedgeFill(wedgeStart.begin(), wedgeStart.end() - 1);
+        for (unsigned int v = 0; v < vertexCount; v++)
+            wedges[wedgeFill[positionOf[v]]++] = v;
+
+        std::vector<Quadric> quadrics(pointCount);
+        std::unordered_map<uint64_t, unsigned int> edgeUses;
+
+        for (size_t i = 0; i + 2 < _indices.size(); i += 3)
+        {
+            unsigned int p[3] = {positionOf[_indices[i]], positionOf[_indices[i + 1]], positionOf[_indices[i + 2]]};
+
+            glm::vec3 normal = glm::cross(points[p[1]] - points[p[0]], points[p[2]] - points[p[0]]);
+            float doubleArea = glm::length(normal);
+            if (doubleArea > 0.0f)
+            {
+                normal /= doubleArea;
+                for (unsigned int corner : p)
+                    quadrics[corner].AddPlane(normal, -glm::dot(normal, points[p[0]]), doubleArea * 0.5f);
+            }
+
+            for (int e = 0; e < 3; e++)
+            {
+                uint64_t a = std::min(p[e], p[(e + 1) % 3]);
+                uint64_t b = std::max(p[e], p[(e + 1) % 3]);
+                if (a != b)
+                    edgeUses[(a << 32) | b]++;
+            }
+        }
+
+        // open borders and non manifold edges would tear or fold if they moved, their ends can only be collapsed into
+        std::vector<bool> locked(pointCount, false);
+        for (const auto &[edge, uses] : edgeUses)
+        {
+            if (uses != 2)
+            {
+                locked[edge >> 32] = true;
+                locked[edge & 0xffffffffu] = true;
+            }
+        }
+
+        std::vector<unsigned int> triangleStart(pointCount + 1);
+        std::vector<unsigned int> pointTriangles;
+        std::vector<uint64_t> edges;
+        std::vector<Collapse> collapses;
+        std::vector<unsigned int> pointTarget(pointCount);
+        std::vector<unsigned int> vertexTarget(vertexCount);
+        std::vector<bool> touched(pointCount);
+        double maxError = 0.0;
+
+        while (_indices.size() > _targetIndexCount)
+        {
+            size_t triangleCount = _indices.size() / 3;
+
+            // triangles around every point, rebuilt each pass since collapses change them
+            std::fill(triangleStart.begin(), triangleStart.end(), 0u);
+            for (unsigned int index : _indices)
+                triangleStart[positionOf[index] + 1]++;
+            for (unsigned int p = 0; p < pointCount; p++)
+                triangleStart[p + 1] += triangleStart[p];
+
+            pointTriangles.resize(_indices.size());
+            std::vector<unsigned int> fill(triangleStart.begin(), triangleStart.end() - 1);
+            for (size_t i = 0; i < _indices.size(); i++)
+                pointTriangles[fill[positionOf[_indices[i]]]++] = i / 3;
+
+            edges.clear();
+            for (size_t i = 0; i < _indices.size(); i += 3)
+            {
+                for (int e = 0; e < 3; e++)
+                {
+                    uint64_t a = positionOf[_indices[i + e]];
+                    uint64_t b = positionOf[_indices[i + (e + 1) % 3]];
+                    if (a != b)
+                        edges.push_back((std::min(a, b) << 32) | std::max(a, b));
+                }
+            }
+
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+            // each edge collapses towards whichever end keeps the error lower, the point itself never moves
+            collapses.clear();
+            for (uint64_t edge : edges)
+            {
+                unsigned int a = edge >> 32;
+                unsigned int b = edge & 0xffffffffu;
+
+                Quadric sum = quadrics[a];
+                sum.Add(quadrics[b]);
+                double scale = sum.weight > 0.0 ? 1.0 / sum.weight : 0.0;
+
+                double errorAB = locked[a] ? -1.0 : sum.Error(points[b]) * scale;
+                double errorBA = locked[b] ? -1.0 : sum.Error(points[a]) * scale;
+
+                if (errorAB >= 0.0 && (errorBA < 0.0 || errorAB <= errorBA))
+                    collapses.push_back({a, b, errorAB});
+                else if (errorBA >= 0.0)
+                    collapses.push_back({b, a, errorBA});
+            }
+
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse &_a, const Collapse &_b) { return _a.error < _b.error; });
+
+            for (unsigned int p = 0; p < pointCount; p++)
+                pointTarget[p] = p;
+            std::fill(touched.begin(), touched.end(), false);
+
+            size_t removeGoal = triangleCount - _targetIndexCount / 3;
+            size_t removed = 0;
+            size_t applied = 0;
+
+            for (const Collapse &collapse : collapses)
+            {
+                if (removed >= removeGoal)
+                    break;
+
+                // a point next to an earlier collapse this pass would be tested against triangles that already moved
+                if (touched[collapse.from] || touched[collapse.to])
+                    continue;
+
+                bool flips = false;
+                size_t dropped = 0;
+
+                for (unsigned int i = triangleStart[collapse.from]; i < triangleStart[collapse.from + 1] && !flips; i++)
+                {
+                    const unsigned int *triangle = &_indices[pointTriangles[i] * 3];
+                    glm::vec3 before[3];
+                    glm::vec3 after[3];
+                    bool dropsOut = false;
+
+                    for (int corner = 0; corner < 3; corner++)
+                    {
+                        unsigned int p = positionOf[triangle[corner]];
+                        dropsOut = dropsOut || p == collapse.to;
+                        before[corner] = points[p];
+                        after[corner] = p == collapse.from ? points[collapse.to] : points[p];
+                    }
+
+                    if (dropsOut)
+                    {
+                        dropped++;
+                        continue;
+                    }
+
+                    glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                    glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+                    flips = glm::dot(normalBefore, normalAfter) <= FLIP_COSINE * glm::length(normalBefore) * glm::length(normalAfter);
+                }
+
+                if (flips)
+                    continue;
+
+                for (unsigned int i = triangleStart[collapse.from]; i < triangleStart[collapse.from + 1]; i++)
+                    for (int corner = 0; corner < 3; corner++)
+                        touched[positionOf[_indices[pointTriangles[i] * 3 + corner]]] = true;
+
+                pointTarget[collapse.from] = collapse.to;
+                quadrics[collapse.to].Add(quadrics[collapse.from]);
+                maxError = std::max(maxError, collapse.error);
+                removed += dropped;
+                applied++;
+            }
+
+            if (applied == 0)
+                break;
+
+            // each moved vertex takes the vertex at the target it shares a triangle with, so seams stay seams,
+            // otherwise the one whose normal and uv are closest
+            for (unsigned int v = 0; v < vertexCount; v++)
+            {
+                vertexTarget[v] = v;
+
+                unsigned int from = positionOf[v];
+                unsigned int to = pointTarget[from];
+                if (to == from)
+                    continue;
+
+                bool found = false;
+                for (unsigned int i = triangleStart[from]; i < triangleStart[from + 1] && !found; i++)
+                {
+                    const unsigned int *triangle = &_indices[pointTriangles[i] * 3];
+                    if (triangle[0] != v && triangle[1] != v && triangle[2] != v)
+                        continue;
+
+                    for (int corner = 0; corner < 3 && !found; corner++)
+                    {
+                        if (positionOf[triangle[corner]] == to)
+                        {
+                            vertexTarget[v] = triangle[corner];
+                            found = true;
+                        }
+                    }
+                }
+
+                float bestDistance = -1.0f;
+                for (unsigned int w = wedgeStart[to]; w < wedgeStart[to + 1] && !found; w++)
+                {
+                    const float *a = &_vertices[v * MODEL_VERTEX_FLOATS];
+                    const float *b = &_vertices[wedges[w] * MODEL_VERTEX_FLOATS];
+                    float distance = 0.0f;
+                    for (unsigned int f = 3; f < MODEL_VERTEX_FLOATS; f++)
+                        distance += (a[f] - b[f]) * (a[f] - b[f]);
+
+                    if (bestDistance < 0.0f || distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        vertexTarget[v] = wedges[w];
+                    }
+                }
+            }
+
+            // triangles that lost a corner to the collapse are gone
+            size_t kept = 0;
+            for (size_t i = 0; i < _indices.size(); i += 3)
+            {
+                unsigned int a = vertexTarget[_indices[i]];
+                unsigned int b = vertexTarget[_indices[i + 1]];
+                unsigned int c = vertexTarget[_indices[i + 2]];
+
+                if (positionOf[a] == positionOf[b] || positionOf[b] == positionOf[c] || positionOf[a] == positionOf[c])
+                    continue;
+
+                _indices[kept++] = a;
+                _indices[kept++] = b;
+                _indices[kept++] = c;
+            }
+
+            _indices.resize(kept);
+        }
+
+        return (float)std::sqrt(maxError);
+    }
+
+    float AverageCacheMissRatio(const std::vector<unsigned int> &_indices, unsigned int _vertexCount, unsigned int _cacheSize)
+    {
+        if (_indices.size() < 3)
+            return 0.0f;
+
+        // a vertex is in the fifo when it was added within the last _cacheSize misses
+        std::vector<size_t> addedAt(_vertexCount, 0);
+        size_t misses = 0;
+
+        for (unsigned int index : _indices)
+        {
+            if (addedAt[index] == 0 || misses - addedAt[index] >= _cacheSize)
+            {
+                misses++;
+                addedAt[index] = misses;
+            }
+        }
+
+        return (float)misses / (_indices.size() / 3);
+    }
+} // end of Canis namespace
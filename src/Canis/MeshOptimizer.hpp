@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Canis
+{
+    // floats per vertex in Model's interleaved layout, position 3, normal 3, uv 2
+    constexpr unsigned int MODEL_VERTEX_FLOATS = 8;
+
+    // merges face corners with the same position, normal and uv into one vertex
+    // _vertices gets the unique vertices interleaved like Model, _indices three per triangle
+    extern void BuildIndexedMesh(const std::vector<glm::vec3> &_positions,
+                                 const std::vector<glm::vec2> &_uvs,
+                                 const std::vector<glm::vec3> &_normals,
+                                 std::vector<float> &_vertices,
+                                 std::vector<unsigned int> &_indices);
+
+    // reorders whole triangles so ones sharing vertices are drawn close together (Forsyth's linear speed
+    // vertex cache optimisation), the vertices themselves and the winding of each triangle are untouched
+    extern void OptimizeVertexCache(std::vector<unsigned int> &_indices, unsigned int _vertexCount);
+
+    // collapses edges with the smallest quadric error (Garland and Heckbert) until _indices has no more than
+    // _targetIndexCount, stopping early when nothing more can go without flipping triangles or moving an open border
+    // only the indices change, every triangle still points into _vertices so all levels can share one vertex buffer
+    // returns how far in model units the result may be from the input surface
+    extern float SimplifyMesh(const std::vector<float> &_vertices, std::vector<unsigned int> &_indices, size_t _targetIndexCount);
+
+    // transformed vertices per triangle through a fifo cache of _cacheSize, 3 is the worst and 0.5 about the best
+    extern float AverageCacheMissRatio(const std::vector<unsigned int> &_indices, unsigned int _vertexCount, unsigned int _cacheSize = 16);
+} // end of Canis namespace
@@ -1,59 +1,242 @@
 #include "Model.hpp"
 #include "IOManager.hpp"
 #include "Debug.hpp"
+#include "GLState.hpp"
+#include "MeshOptimizer.hpp"
+#include "VertexLayout.hpp"
 
 #include <GL/glew.h>
+#include <glm/gtc/packing.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 
 namespace Canis {
 
-void Model::Init(std::string _path) {
+namespace {
+struct CompactVertex {
+    uint16_t position[3]; // unorm inside the bounding cube
+    uint16_t padding;     // keeps the normal on a 4 byte boundary
+    uint32_t normal;      // snorm 2_10_10_10, w unused
+    uint16_t uv[2];       // snorm, or half floats when the uvs leave -1 to 1
+};
+
+static_assert(sizeof(CompactVertex) == 16, "CompactVertex has to match the compact VertexLayout");
+
+// each level aims for half the triangles of the one before, one that cannot get below this share of it ends the chain
+const float LOD_MIN_REDUCTION = 0.8f;
+
+template <typename T>
+void Release(std::vector<T> &_vector) {
+    std::vector<T>().swap(_vector);
+}
+}
+
+void Model::Init(std::string _path, ModelVertexFormat _format, bool _keepMeshData) {
     path = _path;
+    format = _format;
 
     if (LoadOBJ(path, positions, uvs, normals) == false)
     {
         FatalError("Model at path " + _path);
     }
 
-    for (int i = 0; i < positions.size(); i++)
+    // the box center gives a tighter sphere than the origin for models that are not modelled around it
+    glm::vec3 boxMin = positions.empty() ? glm::vec3(0.0f) : positions[0];
+    glm::vec3 boxMax = boxMin;
+    for (const glm::vec3 &position : positions)
     {
-        vertices.push_back(positions[i].x);
-        vertices.push_back(positions[i].y);
-        vertices.push_back(positions[i].z);
-        vertices.push_back(normals[i].x);
-        vertices.push_back(normals[i].y);
-        vertices.push_back(normals[i].z);
-        vertices.push_back(uvs[i].x);
-        vertices.push_back(uvs[i].y);
+        boxMin = glm::min(boxMin, position);
+        boxMax = glm::max(boxMax, position);
     }
 
+    bounds.center = (boxMin + boxMax) * 0.5f;
+    bounds.radius = 0.0f;
+    for (const glm::vec3 &position : positions)
+        bounds.radius = std::max(bounds.radius, glm::length(position - bounds.center));
+
+    // the obj loader gives one vertex per face corner, shared corners are merged and drawn through indices
+    BuildIndexedMesh(positions, uvs, normals, vertices, indices);
+
+    unsigned int vertexCount = vertices.size() / MODEL_VERTEX_FLOATS;
+    float unorderedMissRatio = AverageCacheMissRatio(indices, vertexCount);
+    OptimizeVertexCache(indices, vertexCount);
+
+    Log(path + ": " + std::to_string(positions.size()) + " corners to " + std::to_string(vertexCount) + " vertices, " +
+        "cache misses per triangle " + std::to_string(unorderedMissRatio) + " to " + std::to_string(AverageCacheMissRatio(indices, vertexCount)));
+
+    // every level is simplified from the one before it and stored after it in the same element buffer
+    std::vector<unsigned int> lodIndices = indices;
+    std::vector<unsigned int> elements = indices;
+    float lodError = 0.0f;
+
+    lods.clear();
+    lods.push_back({0, (unsigned int)indices.size(), 0.0f});
+
+    while (lods.size() < MODEL_MAX_LODS)
+    {
+        size_t previousCount = lodIndices.size();
+        float error = SimplifyMesh(vertices, lodIndices, previousCount / 6 * 3);
+
+        if (lodIndices.empty() || lodIndices.size() > previousCount * LOD_MIN_REDUCTION)
+            break;
+
+        OptimizeVertexCache(lodIndices, vertexCount);
+
+        // errors are measured against the level they were simplified from, so they add up down the chain
+        lodError += error;
+        lods.push_back({(unsigned int)elements.size(), (unsigned int)lodIndices.size(), lodError});
+        elements.insert(elements.end(), lodIndices.begin(), lodIndices.end());
+
+        Log(path + ": lod " + std::to_string(lods.size() - 1) + " " + std::to_string(lodIndices.size() / 3) + " triangles, error " + std::to_string(lodError));
+    }
+
+    VertexLayout layout;
+    std::vector<CompactVertex> compactVertices;
+
+    if (format == ModelVertexFormat::COMPACT)
+    {
+        // one scale for all axes keeps the decode a uniform scale, so normals stay valid under the model matrix
+        glm::vec3 extent = boxMax - boxMin;
+        float scale = std::max(extent.x, std::max(extent.y, extent.z));
+        if (scale <= 0.0f)
+            scale = 1.0f;
+
+        positionDecode = glm::vec4(boxMin, scale);
+
+        bool uvsFitSnorm = true;
+        for (size_t i = 0; i < vertices.size(); i += MODEL_VERTEX_FLOATS)
+            uvsFitSnorm = uvsFitSnorm && std::abs(vertices[i + 6]) <= 1.0f && std::abs(vertices[i + 7]) <= 1.0f;
+
+        compactVertices.resize(vertexCount);
+        for (unsigned int v = 0; v < vertexCount; v++)
+        {
+            const float *source = &vertices[v * MODEL_VERTEX_FLOATS];
+            CompactVertex &vertex = compactVertices[v];
+
+            glm::vec3 position = (glm::vec3(source[0], source[1], source[2]) - boxMin) / scale;
+            for (int axis = 0; axis < 3; axis++)
+                vertex.position[axis] = glm::packUnorm1x16(position[axis]);
+            vertex.padding = 0;
+
+            vertex.normal = glm::packSnorm3x10_1x2(glm::vec4(source[3], source[4], source[5], 0.0f));
+
+            for (int axis = 0; axis < 2; axis++)
+                vertex.uv[axis] = uvsFitSnorm ? (uint16_t)glm::packSnorm1x16(source[6 + axis]) : glm::packHalf1x16(source[6 + axis]);
+        }
+
+        layout.Add(0, 3, GL_UNSIGNED_SHORT, true, sizeof(uint16_t) * 4)
+              .Add(1, 4, GL_INT_2_10_10_10_REV, true, sizeof(uint32_t))
+              .Add(2, 2, uvsFitSnorm ? GL_SHORT : GL_HALF_FLOAT, uvsFitSnorm, sizeof(uint16_t) * 2);
+    }
+    else
+    {
+        positionDecode = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+        layout.Add(0, 3, GL_FLOAT, false, sizeof(float) * 3)
+              .Add(1, 3, GL_FLOAT, false, sizeof(float) * 3)
+              .Add(2, 2, GL_FLOAT, false, sizeof(float) * 2);
+    }
+
+    size_t vertexBytes = (size_t)layout.GetStride() * vertexCount;
+    const void *vertexData = format == ModelVertexFormat::COMPACT ? (const void*)compactVertices.data() : (const void*)vertices.data();
+
+    Log(path + ": " + std::to_string(layout.GetStride()) + " bytes per vertex, " + std::to_string(vertexBytes / 1024) + " KB of vertex data");
+
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    GLState::BindVertexArray(VAO);
 
-    glBindVertexArray(VAO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertexData, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertices.size(), &vertices[0], GL_STATIC_DRAW);
+    // half the index memory whenever every vertex can be reached with 16 bits
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    if (vertexCount <= 0xffff)
+    {
+        std::vector<unsigned short> shortIndices(elements.begin(), elements.end());
+        indexType = GL_UNSIGNED_SHORT;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned short) * shortIndices.size(), shortIndices.data(), GL_STATIC_DRAW);
+    }
+    else
+    {
+        indexType = GL_UNSIGNED_INT;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * elements.size(), elements.data(), GL_STATIC_DRAW);
+    }
 
-    // pos
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 8, (void*)0);
-    glEnableVertexAttribArray(0);
+    // position, normal and uv at locations 0, 1 and 2
+    layout.Apply();
 
-    // normals
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 8, (void*)(sizeof(float) * 3));
-    glEnableVertexAttribArray(1);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
+
+    if (!_keepMeshData)
+    {
+        Release(vertices);
+        Release(indices);
+        Release(positions);
+        Release(uvs);
+        Release(normals);
+    }
+}
 
-    // uvs
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 8, (void*)(sizeof(float) * 6));
-    glEnableVertexAttribArray(2);
+void Model:: Draw(unsigned int _lod) {
+    const ModelLod &lod = lods[std::min<size_t>(_lod, lods.size() - 1)];
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindVertexArray(VAO);
+    // not part of the vao, the current value of a disabled attribute belongs to the context
+    glVertexAttrib4fv(MODEL_POSITION_DECODE_LOCATION, &positionDecode[0]);
+    glDrawElements(GL_TRIANGLES, lod.indexCount, indexType, (void*)(lod.firstIndex * indexSize));
 }
 
-void Model:: Draw() {
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, vertices.size()/8);
-    glBindVertexArray(0);
+void Model::DrawInstanced(const ModelInstance *_instances, unsigned int _count, unsigned int _lod) {
+    if (_count == 0)
+        return;
+
+    GLState::BindVertexArray(VAO);
+
+    // the instance buffer is attached to the model's vao the first time it is drawn instanced
+    if (instanceVBO == 0)
+    {
+        glGenBuffers(1, &instanceVBO);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+
+        for (int column = 0; column < 4; column++)
+        {
+            glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(ModelInstance), (void*)(offsetof(ModelInstance, transform) + sizeof(glm::vec4) * column));
+            glEnableVertexAttribArray(3 + column);
+            glVertexAttribDivisor(3 + column, 1);
+        }
+
+        glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(ModelInstance), (void*)offsetof(ModelInstance, color));
+        glEnableVertexAttribArray(7);
+        glVertexAttribDivisor(7, 1);
+
+        glVertexAttribPointer(8, 1, GL_FLOAT, GL_FALSE, sizeof(ModelInstance), (void*)offsetof(ModelInstance, windPhase));
+        glEnableVertexAttribArray(8);
+        glVertexAttribDivisor(8, 1);
+    }
+    else
+    {
+        GLState::BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    }
+
+    // orphan the old storage like SpriteBatch so last frame's draws are not waited on
+    if (_count > instanceCapacity)
+        instanceCapacity = _count;
+
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ModelInstance) * instanceCapacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(ModelInstance) * _count, _instances);
+
+    const ModelLod &lod = lods[std::min<size_t>(_lod, lods.size() - 1)];
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+
+    glVertexAttrib4fv(MODEL_POSITION_DECODE_LOCATION, &positionDecode[0]);
+    glDrawElementsInstanced(GL_TRIANGLES, lod.indexCount, indexType, (void*)(lod.firstIndex * indexSize), _count);
 }
 
 }
\ No newline at end of file
@@ -4,17 +4,58 @@
 #include <vector>
 #include <glm/glm.hpp>
 
+#include "Data/BoundingSphere.hpp"
+
 namespace Canis {
+enum class ModelVertexFormat {
+    FULL,    // 32 bytes, float position, normal and uv
+    COMPACT  // 16 bytes, 16 bit position inside the bounds, 2_10_10_10 normal, 16 bit uv
+};
+
+// model shaders read a vec4 here, position = xyz + aPosition * w, Draw sets it as a constant attribute
+constexpr unsigned int MODEL_POSITION_DECODE_LOCATION = 9;
+
+// levels of detail Init builds at most, including the full mesh
+constexpr unsigned int MODEL_MAX_LODS = 4;
+
+// one level's triangles inside the model's element buffer, every level shares the vertex buffer
+struct ModelLod {
+    unsigned int firstIndex = 0;
+    unsigned int indexCount = 0;
+    float error = 0.0f; // how far in model units this level may be from the full mesh
+};
+
+// per instance data streamed next to the mesh, attribute locations 3 to 6 hold the transform columns
+struct ModelInstance {
+    glm::mat4 transform = glm::mat4(1.0f);
+    glm::vec4 color = glm::vec4(1.0f);  // location 7
+    float windPhase = 0.0f;             // location 8, offsets the sway so a field of plants does not move in lockstep
+};
+
 struct Model {
     std::string path;
     unsigned int VAO;
     unsigned int VBO;
-    std::vector<float> vertices = {};
-    std::vector<glm::vec3> positions = {};
+    unsigned int EBO;
+    unsigned int indexType; // GL_UNSIGNED_SHORT when the vertex count allows it
+    std::vector<ModelLod> lods = {}; // lods[0] is the full mesh, each following one has about half the triangles
+    ModelVertexFormat format = ModelVertexFormat::COMPACT;
+    glm::vec4 positionDecode = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    // the cpu copies below are emptied once uploaded unless Init is asked to keep them
+    std::vector<float> vertices = {}; // unique vertices, MODEL_VERTEX_FLOATS each
+    std::vector<unsigned int> indices = {}; // lod 0, three per triangle, ordered for the post transform cache
+    std::vector<glm::vec3> positions = {}; // one per face corner as loaded, indices do not point into these
     std::vector<glm::vec2> uvs = {};
     std::vector<glm::vec3> normals = {};
+    BoundingSphere bounds; // model space, around the center of the positions' box
+
+    unsigned int instanceVBO = 0;
+    unsigned int instanceCapacity = 0;
 
-    void Init(std::string _path);
-    void Draw();
+    void Init(std::string _path, ModelVertexFormat _format = ModelVertexFormat::COMPACT, bool _keepMeshData = false);
+    // _lod past the last level draws the last level
+    void Draw(unsigned int _lod = 0);
+    // one draw call for every instance, use a shader that reads the instance attributes
+    void DrawInstanced(const ModelInstance *_instances, unsigned int _count, unsigned int _lod = 0);
 };
 }
\ No newline at end of file
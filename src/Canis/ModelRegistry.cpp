@@ -0,0 +1,161 @@
+#include "ModelRegistry.hpp"
+
+#include <algorithm>
+
+namespace Canis
+{
+    namespace
+    {
+        // keeps an instance the camera is inside of from dividing by zero, it gets the full mesh anyway
+        const float LOD_MIN_DISTANCE = 0.001f;
+    }
+
+    Model *ModelRegistry::Load(const std::string &_path)
+    {
+        auto it = m_models.find(_path);
+        if (it != m_models.end())
+            return it->second.get();
+
+        std::unique_ptr<Model> model = std::make_unique<Model>();
+        model->Init(_path);
+
+        Model *result = model.get();
+        m_models[_path] = std::move(model);
+        return result;
+    }
+
+    void ModelRegistry::Submit(Model *_model, const glm::mat4 &_transform, const glm::vec4 &_color, float _windPhase, unsigned int *_lodState)
+    {
+        auto it = m_batchIndex.find(_model);
+
+        if (it == m_batchIndex.end())
+        {
+            it = m_batchIndex.emplace(_model, m_batches.size()).first;
+            m_batches.push_back({_model, {}, {}});
+        }
+
+        m_batches[it->second].instances.push_back({_transform, _color, _windPhase});
+        m_batches[it->second].lodStates.push_back(_lodState);
+    }
+
+    unsigned int ModelRegistry::SelectLod(const Model &_model, const BoundingSphere &_sphere, unsigned int _current) const
+    {
+        unsigned int last = _model.lods.size() - 1;
+        unsigned int lod = std::min(_current, last);
+
+        // the error grows with the instance's scale the same way its bounding radius does
+        float scale = _model.bounds.radius > 0.0f ? _sphere.radius / _model.bounds.radius : 1.0f;
+        float distance = std::max(glm::length(_sphere.center - m_lodSettings.cameraPosition) - _sphere.radius, LOD_MIN_DISTANCE);
+        float pixelsPerUnit = m_lodSettings.projectionScale * scale / distance;
+
+        auto fits = [&](unsigned int _lod, float _pixels) { return _model.lods[_lod].error * pixelsPerUnit <= _pixels; };
+
+        // past the band the current level is too coarse, go back to the coarsest one that fits
+        if (!fits(lod, m_lodSettings.pixelError * (1.0f + m_lodSettings.hysteresis)))
+        {
+            while (lod > 0 && !fits(lod, m_lodSettings.pixelError))
+                lod--;
+            return lod;
+        }
+
+        while (lod < last && fits(lod + 1, m_lodSettings.pixelError * (1.0f - m_lodSettings.hysteresis)))
+            lod++;
+
+        return lod;
+    }
+
+    void ModelRegistry::Render(const Frustum &_frustum, JobSystem *_jobSystem)
+    {
+        m_drawCallCount = 0;
+        m_instanceCount = 0;
+        m_triangleCount = 0;
+        m_cullStats = {};
+
+        for (Batch &batch : m_batches)
+        {
+            if (batch.instances.empty())
+                continue;
+
+            m_culler.Clear();
+            m_culler.Reserve(batch.instances.size());
+
+            m_spheres.clear();
+            for (const ModelInstance &instance : batch.instances)
+            {
+                m_spheres.push_back(TransformSphere(batch.model->bounds, instance.transform));
+                m_culler.Add(m_spheres.back());
+            }
+
+            m_culler.Cull(_frustum, _jobSystem);
+            m_cullStats.visible += m_culler.GetStats().visible;
+            m_cullStats.culled += m_culler.GetStats().culled;
+
+            // visible instances are packed to the front in their submit order
+            size_t visible = 0;
+            for (size_t i = 0; i < batch.instances.size(); i++)
+            {
+                if (m_culler.IsVisible(i))
+                {
+                    batch.instances[visible] = batch.instances[i];
+                    batch.lodStates[visible] = batch.lodStates[i];
+                    m_spheres[visible] = m_spheres[i];
+                    visible++;
+                }
+            }
+
+            batch.instances.resize(visible);
+            batch.lodStates.resize(visible);
+
+            const std::vector<ModelLod> &lods = batch.model->lods;
+
+            if (m_lodSettings.enabled && lods.size() > 1)
+            {
+                // counting sort by level keeps the submit order inside each level's draw
+                std::vector<unsigned int> firstOfLod(lods.size() + 1, 0);
+                m_instanceLods.resize(visible);
+
+                for (size_t i = 0; i < visible; i++)
+                {
+                    unsigned int *state = batch.lodStates[i];
+                    unsigned int lod = SelectLod(*batch.model, m_spheres[i], state != nullptr ? *state : 0);
+                    if (state != nullptr)
+                        *state = lod;
+
+                    m_instanceLods[i] = lod;
+                    firstOfLod[lod + 1]++;
+                }
+
+                for (size_t lod = 0; lod < lods.size(); lod++)
+                    firstOfLod[lod + 1] += firstOfLod[lod];
+
+                m_lodInstances.resize(visible);
+                std::vector<unsigned int> fill(firstOfLod.begin(), firstOfLod.end() - 1);
+                for (size_t i = 0; i < visible; i++)
+                    m_lodInstances[fill[m_instanceLods[i]]++] = batch.instances[i];
+
+                for (unsigned int lod = 0; lod < lods.size(); lod++)
+                {
+                    unsigned int count = firstOfLod[lod + 1] - firstOfLod[lod];
+                    if (count == 0)
+                        continue;
+
+                    batch.model->DrawInstanced(m_lodInstances.data() + firstOfLod[lod], count, lod);
+
+                    m_drawCallCount++;
+                    m_triangleCount += count * (lods[lod].indexCount / 3);
+                }
+            }
+            else if (visible > 0)
+            {
+                batch.model->DrawInstanced(batch.instances.data(), visible);
+
+                m_drawCallCount++;
+                m_triangleCount += visible * (lods[0].indexCount / 3);
+            }
+
+            m_instanceCount += visible;
+            batch.instances.clear();
+            batch.lodStates.clear();
+        }
+    }
+} // end of Canis namespace
@@ -0,0 +1,78 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Model.hpp"
+#include "FrustumCuller.hpp"
+
+namespace Canis
+{
+    // picks each instance's level of detail from how many pixels its model's error covers, off by default
+    struct ModelLodSettings
+    {
+        bool enabled = false;
+        glm::vec3 cameraPosition = glm::vec3(0.0f);
+        // viewport height / (2 * tan(fovY / 2)), pixels covered by one unit one unit away from the camera
+        float projectionScale = 1.0f;
+        // a level is used while its error covers no more than this many pixels
+        float pixelError = 1.0f;
+        // share of pixelError an instance has to move past before it switches level, so it does not flicker
+        // between two levels at one distance
+        float hysteresis = 0.25f;
+    };
+
+    // owns every loaded model once per path and collects instances through the frame
+    // Render draws each model that was submitted with a single instanced draw call
+    class ModelRegistry
+    {
+    public:
+        // the same path always returns the same model, so identical props end up in one batch
+        Model *Load(const std::string &_path);
+
+        // _lodState is kept by the caller for each instance and remembers its level between frames for the hysteresis,
+        // without it the level is picked fresh every frame
+        void Submit(Model *_model, const glm::mat4 &_transform, const glm::vec4 &_color = glm::vec4(1.0f), float _windPhase = 0.0f,
+                    unsigned int *_lodState = nullptr);
+
+        void SetLodSettings(const ModelLodSettings &_settings) { m_lodSettings = _settings; }
+
+        // the caller binds the instanced shader and sets its uniforms, instance lists are emptied afterwards
+        // instances whose transformed model bounds are outside _frustum are dropped, the default frustum keeps all
+        // with lods enabled a model takes one draw call for each level its instances use
+        void Render(const Frustum &_frustum = Frustum(), JobSystem *_jobSystem = nullptr);
+
+        unsigned int GetDrawCallCount() { return m_drawCallCount; }
+        unsigned int GetInstanceCount() { return m_instanceCount; }
+        unsigned int GetTriangleCount() { return m_triangleCount; }
+        CullStats GetCullStats() { return m_cullStats; }
+
+    private:
+        struct Batch
+        {
+            Model *model = nullptr;
+            std::vector<ModelInstance> instances = {};
+            std::vector<unsigned int*> lodStates = {}; // one per instance, next to instances since those are uploaded as is
+        };
+
+        unsigned int SelectLod(const Model &_model, const BoundingSphere &_sphere, unsigned int _current) const;
+
+        std::unordered_map<std::string, std::unique_ptr<Model>> m_models = {};
+        // batches live across frames so their instance vectors keep their capacity
+        std::unordered_map<Model*, unsigned int> m_batchIndex = {};
+        std::vector<Batch> m_batches = {};
+
+        FrustumCuller m_culler;
+        CullStats m_cullStats = {};
+
+        ModelLodSettings m_lodSettings = {};
+        std::vector<BoundingSphere> m_spheres = {};
+        std::vector<unsigned int> m_instanceLods = {};
+        std::vector<ModelInstance> m_lodInstances = {}; // visible instances grouped by level
+
+        unsigned int m_drawCallCount = 0;
+        unsigned int m_instanceCount = 0;
+        unsigned int m_triangleCount = 0;
+    };
+} // end of Canis namespace
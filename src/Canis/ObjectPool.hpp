@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Canis
+{
+    struct PoolStats
+    {
+        size_t liveObjects = 0;
+        size_t peakLiveObjects = 0;
+        size_t chunkCount = 0;
+        size_t capacity = 0;
+    };
+
+    // type erased so owners can free an allocation without knowing its type
+    class PoolBase
+    {
+    public:
+        virtual ~PoolBase() {}
+        virtual void Free(void *_object) = 0;
+
+        const PoolStats &GetStats() const { return m_stats; }
+
+    protected:
+        PoolStats m_stats = {};
+    };
+
+    // fixed size slabs threaded with a free list, freed slots are reused before a new chunk is made
+    // once the pool has grown to the peak live count it never touches the general heap again
+    template <typename T, size_t ObjectsPerChunk = 64>
+    class ObjectPool : public PoolBase
+    {
+    public:
+        ObjectPool() {}
+        ObjectPool(const ObjectPool &) = delete;
+        ObjectPool &operator=(const ObjectPool &) = delete;
+
+        // only releases the chunks, objects still live are not destructed so owners Free them first
+        ~ObjectPool()
+        {
+            for (Node *chunk : m_chunks)
+                delete[] chunk;
+        }
+
+        template <typename... Args>
+        T *Allocate(Args &&..._args)
+        {
+            if (m_freeList == nullptr)
+                AddChunk();
+
+            Node *node = m_freeList;
+            m_freeList = node->next;
+
+            T *object = new (node->storage) T(std::forward<Args>(_args)...);
+
+            m_stats.liveObjects++;
+            if (m_stats.liveObjects > m_stats.peakLiveObjects)
+                m_stats.peakLiveObjects = m_stats.liveObjects;
+
+            return object;
+        }
+
+        void Free(T *_object)
+        {
+            _object->~T();
+
+            Node *node = reinterpret_cast<Node *>(_object);
+            node->next = m_freeList;
+            m_freeList = node;
+
+            m_stats.liveObjects--;
+        }
+
+        void Free(void *_object) override
+        {
+            Free(static_cast<T *>(_object));
+        }
+
+    private:
+        union Node
+        {
+            Node *next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        std::vector<Node *> m_chunks = {};
+        Node *m_freeList = nullptr;
+
+        void AddChunk()
+        {
+            Node *chunk = new Node[ObjectsPerChunk];
+
+            // thread the new nodes so the first one is handed out first
+            for (size_t i = 0; i < ObjectsPerChunk - 1; i++)
+                chunk[i].next = &chunk[i + 1];
+            chunk[ObjectsPerChunk - 1].next = m_freeList;
+
+            m_freeList = chunk;
+            m_chunks.push_back(chunk);
+
+            m_stats.chunkCount = m_chunks.size();
+            m_stats.capacity = m_chunks.size() * ObjectsPerChunk;
+        }
+    };
+} // end of Canis namespace
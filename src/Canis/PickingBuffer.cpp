@@ -0,0 +1,164 @@
+#include "PickingBuffer.hpp"
+#include "Debug.hpp"
+#include "GLState.hpp"
+
+#include <GL/glew.h>
+
+namespace Canis
+{
+    PickingBuffer::PickingBuffer()
+    {
+    }
+
+    PickingBuffer::~PickingBuffer()
+    {
+        DestroyAttachments();
+
+        for (unsigned int i = 0; i < READBACK_COUNT; i++)
+        {
+            if (m_fences[i] != nullptr)
+                glDeleteSync((GLsync)m_fences[i]);
+            m_fences[i] = nullptr;
+        }
+
+        if (m_pixelBuffers[0] != 0)
+            glDeleteBuffers(READBACK_COUNT, m_pixelBuffers);
+    }
+
+    void PickingBuffer::Init(int _width, int _height)
+    {
+        m_width = _width;
+        m_height = _height;
+
+        // one int each, the cpu only ever looks at the pixel under the cursor
+        glGenBuffers(READBACK_COUNT, m_pixelBuffers);
+        for (unsigned int i = 0; i < READBACK_COUNT; i++)
+        {
+            GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, m_pixelBuffers[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(int), nullptr, GL_STREAM_READ);
+        }
+        GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        CreateAttachments();
+    }
+
+    void PickingBuffer::Resize(int _width, int _height)
+    {
+        if (_width == m_width && _height == m_height)
+            return;
+
+        m_width = _width;
+        m_height = _height;
+
+        DestroyAttachments();
+        CreateAttachments();
+    }
+
+    void PickingBuffer::Begin()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        glViewport(0, 0, m_width, m_height);
+
+        // glClear would convert the clear color to float, integer attachments are cleared with glClearBufferiv
+        const int clearID = NO_ID;
+        const float clearDepth = 1.0f;
+        glClearBufferiv(GL_COLOR, 0, &clearID);
+        glClearBufferfv(GL_DEPTH, 0, &clearDepth);
+    }
+
+    void PickingBuffer::End(glm::ivec2 _pixel)
+    {
+        Collect();
+
+        bool inside = _pixel.x >= 0 && _pixel.y >= 0 && _pixel.x < m_width && _pixel.y < m_height;
+
+        if (inside && m_pending < READBACK_COUNT)
+        {
+            // with a pixel pack buffer bound the read only queues a copy, the last argument is an offset into it
+            GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, m_pixelBuffers[m_next]);
+            glReadPixels(_pixel.x, _pixel.y, 1, 1, GL_RED_INTEGER, GL_INT, (void *)0);
+            GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            m_fences[m_next] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            m_readFrames[m_next] = m_frame;
+            m_next = (m_next + 1) % READBACK_COUNT;
+            m_pending++;
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        m_frame++;
+    }
+
+    void PickingBuffer::Collect()
+    {
+        while (m_pending > 0)
+        {
+            unsigned int oldest = (m_next + READBACK_COUNT - m_pending) % READBACK_COUNT;
+            GLsync fence = (GLsync)m_fences[oldest];
+
+            // a zero timeout only asks, reads finish in order so the first one still running ends the loop
+            GLenum result = glClientWaitSync(fence, 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED && result != GL_WAIT_FAILED)
+                break;
+
+            glDeleteSync(fence);
+            m_fences[oldest] = nullptr;
+            m_pending--;
+
+            if (result == GL_WAIT_FAILED)
+                continue;
+
+            GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, m_pixelBuffers[oldest]);
+            int *id = (int *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(int), GL_MAP_READ_BIT);
+            if (id != nullptr)
+            {
+                m_id = *id;
+                m_latency = m_frame - m_readFrames[oldest];
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+    }
+
+    void PickingBuffer::CreateAttachments()
+    {
+        glGenTextures(1, &m_idTexture);
+        GLState::BindTexture(GL_TEXTURE_2D, m_idTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32I, m_width, m_height, 0, GL_RED_INTEGER, GL_INT, nullptr);
+        // integer textures are incomplete with linear filtering
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        GLState::BindTexture(GL_TEXTURE_2D, 0);
+
+        // lets 3d callers turn on depth testing so the nearest id wins
+        glGenRenderbuffers(1, &m_depthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_width, m_height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &m_framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_idTexture, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            Error("PickingBuffer framebuffer is not complete");
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void PickingBuffer::DestroyAttachments()
+    {
+        if (m_framebuffer != 0)
+            glDeleteFramebuffers(1, &m_framebuffer);
+        if (m_idTexture != 0)
+            glDeleteTextures(1, &m_idTexture);
+        if (m_depthBuffer != 0)
+            glDeleteRenderbuffers(1, &m_depthBuffer);
+
+        m_framebuffer = 0;
+        m_idTexture = 0;
+        m_depthBuffer = 0;
+    }
+} // end of Canis namespace
@@ -0,0 +1,58 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace Canis
+{
+    // an R32I render target that ids are drawn into, the pixel under the cursor is copied into one of
+    // READBACK_COUNT pixel buffers and only mapped once its fence has passed, so reading an id never stalls
+    // the pipeline, the id arrives a frame or two after it was drawn
+    class PickingBuffer
+    {
+    public:
+        static constexpr unsigned int READBACK_COUNT = 3;
+        // the clear value, nothing was drawn at the pixel
+        static constexpr int NO_ID = -1;
+
+        PickingBuffer();
+        ~PickingBuffer();
+
+        void Init(int _width, int _height);
+        // recreates the attachments when the size changed, pending reads of the old size are still delivered
+        void Resize(int _width, int _height);
+
+        // binds the framebuffer and clears it to NO_ID, draw with a shader writing an int to output 0
+        // blending has to be off while drawing, integer attachments cannot blend
+        void Begin();
+        // queues a read of _pixel, bottom left origin like InputManager::mouse, and binds the default framebuffer
+        // when every pixel buffer is still waiting on the gpu this frame's read is dropped instead of waiting
+        void End(glm::ivec2 _pixel);
+
+        // id from the newest read that has finished, NO_ID until the first one does
+        int GetID() const { return m_id; }
+        // frames between drawing the id GetID returns and it arriving
+        unsigned int GetLatency() const { return m_latency; }
+
+    private:
+        // maps every read whose fence has passed, oldest first, without waiting on the rest
+        void Collect();
+        void CreateAttachments();
+        void DestroyAttachments();
+
+        int m_width = 0;
+        int m_height = 0;
+
+        unsigned int m_framebuffer = 0;
+        unsigned int m_idTexture = 0;
+        unsigned int m_depthBuffer = 0;
+
+        unsigned int m_pixelBuffers[READBACK_COUNT] = {};
+        void *m_fences[READBACK_COUNT] = {}; // GLsync, kept opaque so this header does not need glew
+        unsigned int m_readFrames[READBACK_COUNT] = {};
+        unsigned int m_next = 0;
+        unsigned int m_pending = 0;
+
+        unsigned int m_frame = 0;
+        int m_id = NO_ID;
+        unsigned int m_latency = 0;
+    };
+} // end of Canis namespace
@@ -0,0 +1,195 @@
+#include "ProgramCache.hpp"
+#include "Debug.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Canis
+{
+    namespace
+    {
+        // bump when the file layout changes so old files read as misses
+        const char CACHE_MAGIC[4] = {'C', 'P', 'B', '1'};
+
+        struct CacheHeader
+        {
+            char magic[4];
+            uint32_t format;
+            uint64_t key;
+            uint32_t length;
+        };
+
+        std::string g_directory = "cache/shaders";
+        ProgramCacheStats g_stats = {};
+
+        // FNV-1a, each string goes in with its length so moving text from one to the next changes the key
+        void HashBytes(uint64_t &_hash, const void *_data, size_t _size)
+        {
+            const unsigned char *bytes = (const unsigned char *)_data;
+            for (size_t i = 0; i < _size; i++)
+            {
+                _hash ^= bytes[i];
+                _hash *= 1099511628211ull;
+            }
+        }
+
+        void HashString(uint64_t &_hash, const std::string &_text)
+        {
+            uint64_t length = _text.size();
+            HashBytes(_hash, &length, sizeof(length));
+            HashBytes(_hash, _text.data(), _text.size());
+        }
+
+        std::string GLString(GLenum _name)
+        {
+            const GLubyte *text = glGetString(_name);
+            return text == nullptr ? std::string() : std::string((const char *)text);
+        }
+
+        std::filesystem::path CachePath(uint64_t _key)
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)_key);
+            return std::filesystem::path(g_directory) / name;
+        }
+    }
+
+    void SetProgramCacheDirectory(const std::string &_directory)
+    {
+        g_directory = _directory;
+    }
+
+    bool IsProgramCacheAvailable()
+    {
+        static int formatCount = -1;
+
+        // the context is 3.3 core, program binaries are 4.1 or the extension
+        if (formatCount < 0)
+        {
+            formatCount = 0;
+            if (GLEW_ARB_get_program_binary)
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        }
+
+        return formatCount > 0 && !g_directory.empty();
+    }
+
+    uint64_t ProgramCacheKey(const std::string &_vertexSource, const std::string &_fragmentSource, const std::vector<std::string> &_attributes)
+    {
+        // a driver update can change the binary format without changing its enum, so the strings go in too
+        static const std::string driver = GLString(GL_VENDOR) + "\n" + GLString(GL_RENDERER) + "\n" + GLString(GL_VERSION) + "\n" + GLString(GL_SHADING_LANGUAGE_VERSION);
+
+        uint64_t hash = 14695981039346656037ull;
+        HashBytes(hash, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        HashString(hash, driver);
+        HashString(hash, _vertexSource);
+        HashString(hash, _fragmentSource);
+
+        // AddAttribute binds in call order, so the order is part of the key
+        for (const std::string &attribute : _attributes)
+            HashString(hash, attribute);
+
+        return hash;
+    }
+
+    bool ReadProgramBinary(unsigned int _program, uint64_t _key)
+    {
+        if (!IsProgramCacheAvailable())
+            return false;
+
+        std::filesystem::path path = CachePath(_key);
+        std::ifstream file(path, std::ios::binary);
+        CacheHeader header = {};
+
+        if (!file || !file.read((char *)&header, sizeof(header)) ||
+            memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.key != _key)
+        {
+            g_stats.misses++;
+            return false;
+        }
+
+        // the length comes from disk, a damaged file must not get to pick how much is allocated
+        std::error_code error;
+        uintmax_t fileSize = std::filesystem::file_size(path, error);
+        if (error || fileSize < sizeof(header) || header.length == 0 || header.length > fileSize - sizeof(header))
+        {
+            g_stats.misses++;
+            return false;
+        }
+
+        std::vector<char> binary(header.length);
+        if (!file.read(binary.data(), binary.size()))
+        {
+            g_stats.misses++;
+            return false;
+        }
+
+        // the link status is left for later so a cached program loads alongside the others
+        glProgramBinary(_program, header.format, binary.data(), binary.size());
+        return true;
+    }
+
+    void CountProgramCacheResult(bool _hit)
+    {
+        if (_hit)
+            g_stats.hits++;
+        else
+            g_stats.misses++;
+    }
+
+    void SaveProgramBinary(unsigned int _program, uint64_t _key)
+    {
+        if (!IsProgramCacheAvailable())
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(_program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(_program, length, &length, &format, binary.data());
+
+        CacheHeader header = {};
+        memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        header.format = format;
+        header.key = _key;
+        header.length = length;
+
+        std::error_code error;
+        std::filesystem::create_directories(g_directory, error);
+
+        // written next to the final name and renamed, a run that dies halfway never leaves a short file behind
+        std::filesystem::path path = CachePath(_key);
+        std::filesystem::path partial = path;
+        partial += ".partial";
+
+        {
+            std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+            if (!file.write((const char *)&header, sizeof(header)) || !file.write(binary.data(), length))
+            {
+                Warning("Unable to write program cache file " + partial.string());
+                return;
+            }
+        }
+
+        std::filesystem::rename(partial, path, error);
+        if (error)
+            Warning("Unable to write program cache file " + path.string());
+    }
+
+    void AddProgramLinkTime(double _milliseconds)
+    {
+        g_stats.linkMilliseconds += _milliseconds;
+    }
+
+    ProgramCacheStats GetProgramCacheStats()
+    {
+        return g_stats;
+    }
+} // end of Canis namespace
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Canis
+{
+    struct ProgramCacheStats
+    {
+        unsigned int hits = 0;
+        unsigned int misses = 0;
+        double linkMilliseconds = 0.0; // main thread time in BeginLink and FinishLink, cache loads and source compiles together
+    };
+
+    // linked programs are kept as driver binaries in _directory between runs, an empty path turns the cache off
+    extern void SetProgramCacheDirectory(const std::string &_directory);
+
+    // covers everything that changes the linked program, a new driver or gpu gives every program a new key
+    extern uint64_t ProgramCacheKey(const std::string &_vertexSource,
+                                    const std::string &_fragmentSource,
+                                    const std::vector<std::string> &_attributes);
+
+    // true when a binary for _key was on disk and went to glProgramBinary, false means compile from source
+    // the driver can still refuse it, GL_LINK_STATUS on _program tells, report that to CountProgramCacheResult
+    extern bool ReadProgramBinary(unsigned int _program, uint64_t _key);
+    extern void CountProgramCacheResult(bool _hit);
+
+    // call on a linked program that had GL_PROGRAM_BINARY_RETRIEVABLE_HINT set before linking
+    extern void SaveProgramBinary(unsigned int _program, uint64_t _key);
+
+    // false when the context cannot hand out program binaries, Read and Save do nothing then
+    extern bool IsProgramCacheAvailable();
+
+    extern void AddProgramLinkTime(double _milliseconds);
+    extern ProgramCacheStats GetProgramCacheStats();
+} // end of Canis namespace
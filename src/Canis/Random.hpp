@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+
+namespace Canis
+{
+    // small pcg32 generator, unlike rand() every instance has its own state and the sequence for a
+    // seed is the same on every platform and standard library
+    class Random
+    {
+    public:
+        Random(uint64_t _seed = 0x853c49e6748fea9bull) { Seed(_seed); }
+
+        void Seed(uint64_t _seed)
+        {
+            m_state = 0u;
+            Next();
+            m_state += _seed;
+            Next();
+        }
+
+        uint32_t Next()
+        {
+            uint64_t old = m_state;
+            m_state = old * 6364136223846793005ull + INCREMENT;
+            uint32_t xorShifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+            uint32_t rotation = (uint32_t)(old >> 59u);
+            return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31u));
+        }
+
+        // [0, _count)
+        uint32_t Range(uint32_t _count) { return (uint32_t)(((uint64_t)Next() * _count) >> 32); }
+
+        // [0, 1)
+        float Float01() { return (Next() >> 8) * (1.0f / 16777216.0f); }
+
+        // stateless mix of a few values, gives threads a random number that does not depend on
+        // which of them asks first
+        static uint32_t Hash(uint64_t _a, uint64_t _b, uint64_t _c)
+        {
+            uint64_t x = _a ^ (_b * 0x9e3779b97f4a7c15ull) ^ (_c * 0xc2b2ae3d27d4eb4full);
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return (uint32_t)((x ^ (x >> 31)) >> 32);
+        }
+
+    private:
+        static constexpr uint64_t INCREMENT = 1442695040888963407ull;
+        uint64_t m_state = 0u;
+    };
+} // end of Canis namespace
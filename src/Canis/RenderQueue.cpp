@@ -0,0 +1,116 @@
+#include "RenderQueue.hpp"
+#include "GLState.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+
+namespace Canis
+{
+    namespace
+    {
+        const uint64_t TRANSLUCENT_BIT = 1ull << 59;
+        const uint64_t DEPTH_MAX = (1ull << 24) - 1;
+    }
+
+    uint64_t RenderQueue::MakeKey(unsigned int _layer, bool _translucent, unsigned int _shader, unsigned int _texture, unsigned int _mesh, float _depth)
+    {
+        uint64_t depth = (uint64_t)(std::clamp(_depth, 0.0f, 1.0f) * DEPTH_MAX);
+        uint64_t state = ((uint64_t)(_shader & 0x7ff) << 24) | ((uint64_t)(_texture & 0xfff) << 12) | (uint64_t)(_mesh & 0xfff);
+        uint64_t key = (uint64_t)(std::min(_layer, MAX_LAYER)) << 60;
+
+        if (_translucent)
+            return key | TRANSLUCENT_BIT | ((DEPTH_MAX - depth) << 35) | state;
+
+        return key | (state << 24) | depth;
+    }
+
+    void RenderQueue::SetCamera(const glm::mat4 &_view, float _near, float _far)
+    {
+        m_view = _view;
+        m_near = _near;
+        m_far = _far;
+    }
+
+    void RenderQueue::Submit(const RenderCommand &_command, unsigned int _layer, bool _translucent)
+    {
+        // the camera looks down -z so the distance in front of it is the negated view z
+        float viewDepth = -(m_view * _command.transform[3]).z;
+        float depth = (viewDepth - m_near) / (m_far - m_near);
+
+        Submit(_command, MakeKey(_layer, _translucent, _command.shader->GetProgramID(), _command.texture, _command.vao, depth));
+    }
+
+    void RenderQueue::Submit(const RenderCommand &_command, uint64_t _key)
+    {
+        m_entries.push_back({_key, (unsigned int)m_commands.size()});
+        m_commands.push_back(_command);
+    }
+
+    void RenderQueue::Sort()
+    {
+        size_t count = m_entries.size();
+        if (count < 2)
+            return;
+
+        m_scratch.resize(count);
+
+        // least significant byte first, every pass is stable so the earlier bytes stay in order
+        for (unsigned int shift = 0; shift < 64; shift += 8)
+        {
+            size_t offsets[256] = {};
+
+            for (const SortEntry &entry : m_entries)
+                offsets[(entry.key >> shift) & 0xff]++;
+
+            // most bytes are the same for every key in a frame, those passes would not move anything
+            if (offsets[(m_entries[0].key >> shift) & 0xff] == count)
+                continue;
+
+            size_t total = 0;
+            for (size_t &offset : offsets)
+            {
+                size_t bucket = offset;
+                offset = total;
+                total += bucket;
+            }
+
+            for (const SortEntry &entry : m_entries)
+                m_scratch[offsets[(entry.key >> shift) & 0xff]++] = entry;
+
+            m_entries.swap(m_scratch);
+        }
+    }
+
+    void RenderQueue::Execute()
+    {
+        Sort();
+
+        for (const SortEntry &entry : m_entries)
+        {
+            const RenderCommand &command = m_commands[entry.command];
+
+            // sorted neighbours share most of this, GLState drops the binds that would not change anything
+            GLState::SetBlend((entry.key & TRANSLUCENT_BIT) != 0);
+            command.shader->Use();
+            GLState::BindTexture(0, GL_TEXTURE_2D, command.texture);
+            GLState::BindVertexArray(command.vao);
+
+            command.shader->SetVec4("COLOR", command.color);
+            command.shader->SetMat4("TRANSFORM", command.transform);
+
+            glDrawElements(GL_TRIANGLES, command.indexCount, GL_UNSIGNED_INT, 0);
+        }
+
+        // Window::Create leaves blending on for everything that does not go through the queue
+        GLState::SetBlend(true);
+
+        Clear();
+    }
+
+    void RenderQueue::Clear()
+    {
+        m_commands.clear();
+        m_entries.clear();
+    }
+} // end of Canis namespace
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Shader.hpp"
+
+namespace Canis
+{
+    // one indexed draw of a vao, the shader gets TRANSFORM and COLOR set right before it
+    struct RenderCommand
+    {
+        Shader *shader = nullptr;
+        unsigned int texture = 0;
+        unsigned int vao = 0;
+        unsigned int indexCount = 0;
+        glm::mat4 transform = glm::mat4(1.0f);
+        glm::vec4 color = glm::vec4(1.0f);
+    };
+
+    // collects the draws of a frame and issues them sorted by a 64 bit key instead of in submit order
+    // from the top bit down the key holds
+    //   layer 4 | translucent 1 | opaque:      shader 11 | texture 12 | mesh 12 | depth 24
+    //                           | translucent: far to near depth 24 | shader 11 | texture 12 | mesh 12
+    // so opaque draws are grouped by state and then go front to back, translucent draws keep the
+    // back to front order blending needs and only group state among draws at the same depth
+    // gl names are masked into their fields, a collision costs a redundant bind and never a wrong draw
+    class RenderQueue
+    {
+    public:
+        static constexpr unsigned int MAX_LAYER = 15;
+
+        static uint64_t MakeKey(unsigned int _layer, bool _translucent, unsigned int _shader, unsigned int _texture, unsigned int _mesh, float _depth);
+
+        // view and clip planes used to turn a command's position into its depth
+        void SetCamera(const glm::mat4 &_view, float _near, float _far);
+
+        void Submit(const RenderCommand &_command, unsigned int _layer = 0, bool _translucent = false);
+        void Submit(const RenderCommand &_command, uint64_t _key);
+
+        // radix sorts the keys, the order is readable through GetCommand until the next Submit
+        void Sort();
+        // sorts, draws and empties the queue, blending is switched off for opaque draws and left on after
+        void Execute();
+        void Clear();
+
+        size_t GetCommandCount() const { return m_commands.size(); }
+        const RenderCommand &GetCommand(size_t _sortedIndex) const { return m_commands[m_entries[_sortedIndex].command]; }
+        uint64_t GetKey(size_t _sortedIndex) const { return m_entries[_sortedIndex].key; }
+
+    private:
+        struct SortEntry
+        {
+            uint64_t key;
+            unsigned int command;
+        };
+
+        std::vector<RenderCommand> m_commands = {};
+        std::vector<SortEntry> m_entries = {};
+        std::vector<SortEntry> m_scratch = {};
+
+        glm::mat4 m_view = glm::mat4(1.0f);
+        float m_near = 0.001f;
+        float m_far = 100.0f;
+    };
+} // end of Canis namespace
@@ -1,5 +1,8 @@
 #include "Shader.hpp"
 #include "Debug.hpp"
+#include "GLState.hpp"
+#include "FrameData.hpp"
+#include "ProgramCache.hpp"
 
 #include <GL/glew.h>
 #include <SDL.h>
@@ -9,10 +12,70 @@
 
 namespace Canis
 {
+    bool IsParallelShaderCompileAvailable()
+    {
+        static int available = -1;
+
+        if (available < 0)
+        {
+            // 0xffffffff leaves the thread count to the driver
+            if (GLEW_KHR_parallel_shader_compile)
+                glMaxShaderCompilerThreadsKHR(0xffffffff);
+            else if (GLEW_ARB_parallel_shader_compile)
+                glMaxShaderCompilerThreadsARB(0xffffffff);
+
+            available = GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+        }
+
+        return available == 1;
+    }
+
     Shader::Shader()
     {
     }
 
+    Shader::Shader(const Shader &_other)
+    {
+        *this = _other;
+    }
+
+    Shader &Shader::operator=(const Shader &_other)
+    {
+        if (this == &_other)
+            return *this;
+
+        // a begun link is finished on the source, so only the program it links is shared
+        if (_other.m_programId != 0 && !_other.m_isLinked)
+            const_cast<Shader &>(_other).Link();
+
+        if (m_fragmentShaderId != 0)
+            glDeleteShader(m_fragmentShaderId);
+        if (m_vertexShaderId != 0)
+            glDeleteShader(m_vertexShaderId);
+
+        m_isLinked = _other.m_isLinked;
+        m_linkPending = _other.m_linkPending;
+        m_linkFromCache = _other.m_linkFromCache;
+        m_cacheKey = _other.m_cacheKey;
+
+        m_programId = _other.m_programId;
+        m_vertexShaderId = _other.m_vertexShaderId;
+        m_fragmentShaderId = _other.m_fragmentShaderId;
+
+        m_numberOfAttributes = _other.m_numberOfAttributes;
+
+        m_vertexShaderFilePath = _other.m_vertexShaderFilePath;
+        m_fragmentShaderFilePath = _other.m_fragmentShaderFilePath;
+        m_vertexSource = _other.m_vertexSource;
+        m_fragmentSource = _other.m_fragmentSource;
+        m_attributes = _other.m_attributes;
+
+        m_uniformLocations = _other.m_uniformLocations;
+        m_missingUniforms = _other.m_missingUniforms;
+
+        return *this;
+    }
+
     Shader::~Shader()
     {
         if (m_fragmentShaderId != 0)
@@ -23,36 +86,69 @@ namespace Canis
 
     void Shader::Compile(const std::string &_vertexShaderFilePath, const std::string &_fragmentShaderFilePath)
     {
-        //Getting vertex shaderID
-        m_vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
-        if (m_vertexShaderId == 0)
-            FatalError("Vertex shader failed to be created!");
-
-        //Getting fragment shaderID
-        m_fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
-        if (m_fragmentShaderId == 0)
-            FatalError("Fragment shader failed to be created!");
+        m_vertexShaderFilePath = _vertexShaderFilePath;
+        m_fragmentShaderFilePath = _fragmentShaderFilePath;
+        m_vertexSource = ReadShaderFile(_vertexShaderFilePath);
+        m_fragmentSource = ReadShaderFile(_fragmentShaderFilePath);
 
         m_programId = glCreateProgram();
-
-        CompileShaderFile(_vertexShaderFilePath, m_vertexShaderId);
-        CompileShaderFile(_fragmentShaderFilePath, m_fragmentShaderId);
     }
 
     void Shader::Link()
     {
-        if (m_isLinked)
+        BeginLink();
+        FinishLink();
+    }
+
+    void Shader::BeginLink()
+    {
+        if (m_isLinked || m_linkPending)
             return;
-        
-        glAttachShader(m_programId, m_vertexShaderId);
-        glAttachShader(m_programId, m_fragmentShaderId);
 
-        glLinkProgram(m_programId);
+        Uint64 startCounter = SDL_GetPerformanceCounter();
+
+        // the attribute bindings are already on the program, glProgramBinary keeps the ones the binary was linked with
+        m_cacheKey = ProgramCacheKey(m_vertexSource, m_fragmentSource, m_attributes);
+        m_linkFromCache = ReadProgramBinary(m_programId, m_cacheKey);
+
+        if (!m_linkFromCache)
+            StartSourceLink();
+
+        m_linkPending = true;
+
+        AddProgramLinkTime((SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency());
+    }
+
+    void Shader::FinishLink()
+    {
+        if (!m_linkPending)
+            return;
+
+        Uint64 startCounter = SDL_GetPerformanceCounter();
+
+        // the first status query is where the driver makes us wait for the link
+        GLint isLinked = GL_FALSE;
+        glGetProgramiv(m_programId, GL_LINK_STATUS, &isLinked);
+
+        if (m_linkFromCache)
+        {
+            // the driver may still refuse a binary it wrote itself, after an update for example
+            CountProgramCacheResult(isLinked == GL_TRUE);
+
+            if (isLinked == GL_FALSE)
+            {
+                m_linkFromCache = false;
+                StartSourceLink();
+                glGetProgramiv(m_programId, GL_LINK_STATUS, &isLinked);
+            }
+        }
 
-        GLuint isLinked = 0;
-        glGetProgramiv(m_programId, GL_LINK_STATUS, (int *)&isLinked);
         if (isLinked == GL_FALSE)
         {
+            // the compile logs say more than the link log when a stage did not compile
+            CheckCompileStatus(m_vertexShaderFilePath, m_vertexShaderId);
+            CheckCompileStatus(m_fragmentShaderFilePath, m_fragmentShaderId);
+
             GLint maxLength = 0;
             glGetProgramiv(m_programId, GL_INFO_LOG_LENGTH, &maxLength);
 
@@ -62,18 +158,64 @@ namespace Canis
             glDeleteProgram(m_programId);
 
             FatalError("Shader failed to link!\nOpengl Error: " + std::string(infoLog.begin(), infoLog.end()));
-        } else {
-            m_isLinked = true;
         }
 
-        glDetachShader(m_programId, m_vertexShaderId);
-        glDetachShader(m_programId, m_fragmentShaderId);
-        glDeleteShader(m_vertexShaderId);
-        glDeleteShader(m_fragmentShaderId);
+        if (!m_linkFromCache)
+        {
+            glDetachShader(m_programId, m_vertexShaderId);
+            glDetachShader(m_programId, m_fragmentShaderId);
+            glDeleteShader(m_vertexShaderId);
+            glDeleteShader(m_fragmentShaderId);
+            m_vertexShaderId = 0;
+            m_fragmentShaderId = 0;
+
+            SaveProgramBinary(m_programId, m_cacheKey);
+        }
+
+        m_linkPending = false;
+        m_isLinked = true;
+        CacheUniformLocations();
+
+        // shaders that declare the per frame block read it from the shared buffer
+        GLuint frameDataBlock = glGetUniformBlockIndex(m_programId, "FrameData");
+        if (frameDataBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(m_programId, frameDataBlock, FRAME_DATA_BINDING);
+
+        // the program holds everything from here on
+        m_vertexSource = std::string();
+        m_fragmentSource = std::string();
+
+        AddProgramLinkTime((SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency());
+    }
+
+    void Shader::StartSourceLink()
+    {
+        //Getting vertex shaderID
+        m_vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
+        if (m_vertexShaderId == 0)
+            FatalError("Vertex shader failed to be created!");
+
+        //Getting fragment shaderID
+        m_fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
+        if (m_fragmentShaderId == 0)
+            FatalError("Fragment shader failed to be created!");
+
+        // no status queries here, a query would wait for the compile and keep the next one from overlapping it
+        CompileShaderFile(m_vertexShaderFilePath, m_vertexSource, m_vertexShaderId);
+        CompileShaderFile(m_fragmentShaderFilePath, m_fragmentSource, m_fragmentShaderId);
+
+        glAttachShader(m_programId, m_vertexShaderId);
+        glAttachShader(m_programId, m_fragmentShaderId);
+
+        if (IsProgramCacheAvailable())
+            glProgramParameteri(m_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        glLinkProgram(m_programId);
     }
 
     void Shader::AddAttribute(const std::string &_attributeName)
     {
+        m_attributes.push_back(_attributeName);
         glBindAttribLocation(m_programId, m_numberOfAttributes++, _attributeName.c_str());
     }
 
@@ -86,81 +228,143 @@ namespace Canis
         return location;
     }
 
-    void Shader::Use()
+    int Shader::FindUniformLocation(UniformId _name) const
     {
-        glUseProgram(m_programId);
-        for (int i = 0; i < m_numberOfAttributes; i++)
+        auto range = m_uniformLocations.equal_range(_name.hash);
+        for (auto it = range.first; it != range.second; ++it)
+            if (it->second.name == _name.name)
+                return it->second.location;
+
+        std::string name(_name.name);
+        if (m_missingUniforms.insert(name).second)
+        {
+            Error("Uniform " + name + " not found in shader " + m_vertexShaderFilePath + " " + m_fragmentShaderFilePath +
+                  (m_isLinked ? "" : ", it was set before the shader was linked"));
+        }
+
+        return -1;
+    }
+
+    void Shader::CacheUniformLocations()
+    {
+        m_uniformLocations.clear();
+
+        GLint uniformCount = 0;
+        GLint maxNameLength = 0;
+        glGetProgramiv(m_programId, GL_ACTIVE_UNIFORMS, &uniformCount);
+        glGetProgramiv(m_programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+        std::vector<GLchar> nameBuffer(maxNameLength + 1);
+
+        auto addLocation = [this](const std::string &_uniformName) {
+            GLint location = glGetUniformLocation(m_programId, _uniformName.c_str());
+            if (location < 0)
+                return;
+
+            m_uniformLocations.insert({UniformId(_uniformName).hash, {_uniformName, location}});
+        };
+
+        for (GLint i = 0; i < uniformCount; i++)
         {
-            glEnableVertexAttribArray(i);
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(m_programId, (GLuint)i, maxNameLength, &length, &size, &type, nameBuffer.data());
+
+            std::string uniformName(nameBuffer.data(), length);
+
+            // arrays of basic types are reported as NAME[0], also register NAME and every element
+            size_t bracket = uniformName.find('[');
+            if (bracket != std::string::npos && uniformName.back() == ']')
+            {
+                std::string baseName = uniformName.substr(0, bracket);
+                addLocation(baseName);
+                for (GLint element = 0; element < size; element++)
+                    addLocation(baseName + "[" + std::to_string(element) + "]");
+            }
+            else
+            {
+                addLocation(uniformName);
+            }
         }
     }
 
+    // the vao remembers which attribute arrays are enabled so only the program changes here
+    void Shader::Use()
+    {
+        // a program from BeginLink is finished the first time it is used
+        if (m_linkPending)
+            FinishLink();
+
+        GLState::UseProgram(m_programId);
+    }
+
     void Shader::UnUse()
     {
-        glUseProgram(0);
+        GLState::UseProgram(0);
     }
 
-    void Shader::SetBool(const std::string &_name, bool _value) const
+    void Shader::SetBool(UniformId _name, bool _value) const
     {         
-        glUniform1i(glGetUniformLocation(m_programId, _name.c_str()), (int)_value); 
+        glUniform1i(FindUniformLocation(_name), (int)_value); 
     }
     
-    void Shader::SetInt(const std::string &_name, int _value) const
+    void Shader::SetInt(UniformId _name, int _value) const
     { 
-        glUniform1i(glGetUniformLocation(m_programId, _name.c_str()), _value); 
+        glUniform1i(FindUniformLocation(_name), _value); 
     }
     
-    void Shader::SetFloat(const std::string &_name, float _value) const
+    void Shader::SetFloat(UniformId _name, float _value) const
     { 
-        glUniform1f(glGetUniformLocation(m_programId, _name.c_str()), _value); 
+        glUniform1f(FindUniformLocation(_name), _value); 
     }
     
-    void Shader::SetVec2(const std::string &_name, const glm::vec2 &_value) const
+    void Shader::SetVec2(UniformId _name, const glm::vec2 &_value) const
     { 
-        glUniform2fv(glGetUniformLocation(m_programId, _name.c_str()), 1, &_value[0]); 
+        glUniform2fv(FindUniformLocation(_name), 1, &_value[0]); 
     }
 
-    void Shader::SetVec2(const std::string &_name, float _x, float _y) const
+    void Shader::SetVec2(UniformId _name, float _x, float _y) const
     { 
-        glUniform2f(glGetUniformLocation(m_programId, _name.c_str()), _x, _y); 
+        glUniform2f(FindUniformLocation(_name), _x, _y); 
     }
     
-    void Shader::SetVec3(const std::string &_name, const glm::vec3 &_value) const
+    void Shader::SetVec3(UniformId _name, const glm::vec3 &_value) const
     { 
-        glUniform3fv(glGetUniformLocation(m_programId, _name.c_str()), 1, &_value[0]); 
+        glUniform3fv(FindUniformLocation(_name), 1, &_value[0]); 
     }
 
-    void Shader::SetVec3(const std::string &_name, float _x, float _y, float _z) const
+    void Shader::SetVec3(UniformId _name, float _x, float _y, float _z) const
     { 
-        glUniform3f(glGetUniformLocation(m_programId, _name.c_str()), _x, _y, _z); 
+        glUniform3f(FindUniformLocation(_name), _x, _y, _z); 
     }
     
-    void Shader::SetVec4(const std::string &_name, const glm::vec4 &_value) const
+    void Shader::SetVec4(UniformId _name, const glm::vec4 &_value) const
     { 
-        glUniform4fv(glGetUniformLocation(m_programId, _name.c_str()), 1, &_value[0]); 
+        glUniform4fv(FindUniformLocation(_name), 1, &_value[0]); 
     }
 
-    void Shader::SetVec4(const std::string &_name, float _x, float _y, float _z, float _w) 
+    void Shader::SetVec4(UniformId _name, float _x, float _y, float _z, float _w) 
     { 
-        glUniform4f(glGetUniformLocation(m_programId, _name.c_str()), _x, _y, _z, _w); 
+        glUniform4f(FindUniformLocation(_name), _x, _y, _z, _w); 
     }
     
-    void Shader::SetMat2(const std::string &_name, const glm::mat2 &_mat) const
+    void Shader::SetMat2(UniformId _name, const glm::mat2 &_mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(m_programId, _name.c_str()), 1, GL_FALSE, &_mat[0][0]);
+        glUniformMatrix2fv(FindUniformLocation(_name), 1, GL_FALSE, &_mat[0][0]);
     }
     
-    void Shader::SetMat3(const std::string &_name, const glm::mat3 &_mat) const
+    void Shader::SetMat3(UniformId _name, const glm::mat3 &_mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(m_programId, _name.c_str()), 1, GL_FALSE, &_mat[0][0]);
+        glUniformMatrix3fv(FindUniformLocation(_name), 1, GL_FALSE, &_mat[0][0]);
     }
     
-    void Shader::SetMat4(const std::string &_name, const glm::mat4 &_mat) const
+    void Shader::SetMat4(UniformId _name, const glm::mat4 &_mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(m_programId, _name.c_str()), 1, GL_FALSE, &_mat[0][0]);
+        glUniformMatrix4fv(FindUniformLocation(_name), 1, GL_FALSE, &_mat[0][0]);
     }
 
-    void Shader::CompileShaderFile(const std::string &_filePath, unsigned int &_id)
+    std::string Shader::ReadShaderFile(const std::string &_filePath)
     {
         SDL_RWops* shaderFile = SDL_RWFromFile(_filePath.c_str(), "r");
 
@@ -171,17 +375,25 @@ namespace Canis
         void* shaderFileData = SDL_LoadFile_RW(shaderFile, &shaderFileLength, true);
         std::string shaderFileCode(static_cast<char*>(shaderFileData), shaderFileLength);
 
-        const char *contentsPtr = shaderFileCode.c_str();
+        if (shaderFileData != nullptr)
+            SDL_free(shaderFileData);
+
+        return shaderFileCode;
+    }
+
+    void Shader::CompileShaderFile(const std::string &_filePath, const std::string &_source, unsigned int &_id)
+    {
+        const char *contentsPtr = _source.c_str();
         glShaderSource(_id, 1, &contentsPtr, nullptr);
 
         glCompileShader(_id);
+    }
 
+    void Shader::CheckCompileStatus(const std::string &_filePath, unsigned int _id)
+    {
         int success = 0;
         glGetShaderiv(_id, GL_COMPILE_STATUS, &success);
 
-        if (shaderFileData != nullptr)
-            SDL_free(shaderFileData);
-
         if (success == GL_FALSE)
         {
             int maxLength = 0;
@@ -1,39 +1,90 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace Canis
 {
+    // FNV-1a so uniform names can be hashed at compile time
+    constexpr unsigned int HashUniformName(const char *_name, size_t _length)
+    {
+        unsigned int hash = 2166136261u;
+        for (size_t i = 0; i < _length; i++)
+        {
+            hash ^= (unsigned char)_name[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // handle used to look up a uniform without building a string or asking the driver
+    // string literals are hashed at compile time, std::string is hashed when it is passed in
+    // the name rides along so a lookup can tell two names with the same hash apart, it points into the
+    // caller's string and only lives as long as the call it is passed to
+    struct UniformId
+    {
+        unsigned int hash;
+        std::string_view name;
+
+        template <size_t N>
+        consteval UniformId(const char (&_name)[N]) : hash(HashUniformName(_name, N - 1)), name(_name, N - 1) {}
+        UniformId(const std::string &_name) : hash(HashUniformName(_name.c_str(), _name.size())), name(_name) {}
+    };
+
+    // GL_KHR_parallel_shader_compile or the ARB version, the first call lets the driver use all its compiler threads
+    extern bool IsParallelShaderCompileAvailable();
+
     class Shader
     {
     public:
         Shader();
+        // copies share the program, so the link of _other is finished first and no copy is left holding
+        // the shader objects that FinishLink deletes, copy once the attributes are added
+        Shader(const Shader &_other);
+        Shader &operator=(const Shader &_other);
         ~Shader();
 
+        // reads the sources, they are compiled by Link and only when the program cache has no binary for them
         void Compile(const std::string &_vertexShaderFilePath, const std::string &_fragmentShaderFilePath);
         void Link();
+        // Link in two halves, BeginLink hands the compile and link to the driver without asking how they went
+        // and FinishLink asks, so programs begun together build at the same time, Use finishes a pending link
+        void BeginLink();
+        void FinishLink();
         void AddAttribute(const std::string &_attributeName);
         void Use();
         void UnUse();
-        void SetBool(const std::string &_name, bool _value) const;
-        void SetInt(const std::string &_name, int value) const;
-        void SetFloat(const std::string &_name, float _value) const;
-        void SetVec2(const std::string &_name, const glm::vec2 &_value) const;
-        void SetVec2(const std::string &_name, float _x, float _y) const;
-        void SetVec3(const std::string &_name, const glm::vec3 &_value) const;
-        void SetVec3(const std::string &_name, float _x, float _y, float _z) const;
-        void SetVec4(const std::string &_name, const glm::vec4 &_value) const;
-        void SetVec4(const std::string &_name, float _x, float _y, float _z, float _w);
-        void SetMat2(const std::string &_name, const glm::mat2 &_mat) const;
-        void SetMat3(const std::string &_name, const glm::mat3 &_mat) const;
-        void SetMat4(const std::string &_name, const glm::mat4 &_mat) const;
+        void SetBool(UniformId _name, bool _value) const;
+        void SetInt(UniformId _name, int value) const;
+        void SetFloat(UniformId _name, float _value) const;
+        void SetVec2(UniformId _name, const glm::vec2 &_value) const;
+        void SetVec2(UniformId _name, float _x, float _y) const;
+        void SetVec3(UniformId _name, const glm::vec3 &_value) const;
+        void SetVec3(UniformId _name, float _x, float _y, float _z) const;
+        void SetVec4(UniformId _name, const glm::vec4 &_value) const;
+        void SetVec4(UniformId _name, float _x, float _y, float _z, float _w);
+        void SetMat2(UniformId _name, const glm::mat2 &_mat) const;
+        void SetMat3(UniformId _name, const glm::mat3 &_mat) const;
+        void SetMat4(UniformId _name, const glm::mat4 &_mat) const;
 
         bool IsLinked() { return m_isLinked; }
         int GetUniformLocation(const std::string &uniformName);
+        // returns -1 for names that are not active in the linked program, same as glGetUniformLocation
+        // and reports each such name once, a typo shows up instead of silently setting nothing
+        // like the Set functions that call it, only from the thread that owns the GL context
+        int FindUniformLocation(UniformId _name) const;
         int GetProgramID() { return m_programId; }
 
     private:
         bool m_isLinked = false;
+        bool m_linkPending = false;
+        bool m_linkFromCache = false;
+        uint64_t m_cacheKey = 0;
 
         unsigned int m_programId = 0;
         unsigned int m_vertexShaderId = 0;
@@ -41,7 +92,27 @@ namespace Canis
 
         int m_numberOfAttributes = 0;
 
-        void CompileShaderFile(const std::string &_filePath, unsigned int &_id);
+        std::string m_vertexShaderFilePath;
+        std::string m_fragmentShaderFilePath;
+        std::string m_vertexSource;
+        std::string m_fragmentSource;
+        std::vector<std::string> m_attributes = {}; // in binding order, part of the program cache key
+
+        struct CachedUniform
+        {
+            std::string name;
+            int location;
+        };
+
+        // keyed by name hash, names that collide each keep their own entry
+        std::unordered_multimap<unsigned int, CachedUniform> m_uniformLocations = {};
+        mutable std::unordered_set<std::string> m_missingUniforms = {}; // already reported, written on the GL thread only
+
+        void CacheUniformLocations();
+        std::string ReadShaderFile(const std::string &_filePath);
+        void StartSourceLink();
+        void CompileShaderFile(const std::string &_filePath, const std::string &_source, unsigned int &_id);
+        void CheckCompileStatus(const std::string &_filePath, unsigned int _id);
     };
 
 } // end of Canis namespace
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "ShaderLibrary.hpp"
+#include "Debug.hpp"
+
+namespace Canis
+{
+    Shader *ShaderLibrary::Add(const std::string &_name,
+                               const std::string &_vertexShaderFilePath,
+                               const std::string &_fragmentShaderFilePath,
+                               const std::vector<std::string> &_attributes)
+    {
+        if (m_shaders.find(_name) != m_shaders.end())
+        {
+            Warning("ShaderLibrary already has a shader named " + _name);
+            return m_shaders[_name].get();
+        }
+
+        std::unique_ptr<Shader> shader = std::make_unique<Shader>();
+        shader->Compile(_vertexShaderFilePath, _fragmentShaderFilePath);
+
+        for (const std::string &attribute : _attributes)
+            shader->AddAttribute(attribute);
+
+        Shader *result = shader.get();
+        m_shaders[_name] = std::move(shader);
+        m_added.push_back(result);
+        return result;
+    }
+
+    void ShaderLibrary::Build()
+    {
+        // asks for the driver's compiler threads before the first compile is handed over
+        IsParallelShaderCompileAvailable();
+
+        for (Shader *shader : m_added)
+            shader->BeginLink();
+
+        m_added.clear();
+    }
+
+    Shader *ShaderLibrary::Get(const std::string &_name)
+    {
+        auto it = m_shaders.find(_name);
+        if (it == m_shaders.end())
+            return nullptr;
+
+        // a shader asked for before Build starts its link here, nothing waits until Use
+        it->second->BeginLink();
+
+        return it->second.get();
+    }
+} // end of Canis namespace
@@ -0,0 +1,33 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Shader.hpp"
+
+namespace Canis
+{
+    // owns shaders by name and builds them together, Build starts every compile and link before any status
+    // is asked for, so the driver works on all of them at once instead of one after another
+    class ShaderLibrary
+    {
+    public:
+        // reads the sources and binds the attributes in order, nothing is compiled until Build
+        Shader *Add(const std::string &_name,
+                    const std::string &_vertexShaderFilePath,
+                    const std::string &_fragmentShaderFilePath,
+                    const std::vector<std::string> &_attributes = {});
+
+        // begins the link of every shader added since the last Build
+        void Build();
+
+        // never waits for the driver, the first Use or copy of the shader finishes its link
+        // so Use it before setting uniforms, nullptr for a name that was never added
+        Shader *Get(const std::string &_name);
+
+    private:
+        std::unordered_map<std::string, std::unique_ptr<Shader>> m_shaders = {};
+        std::vector<Shader*> m_added = {};
+    };
+} // end of Canis namespace
@@ -0,0 +1,24 @@
+#pragma once
+
+// picks the widest instruction set the compiler was told it may use, CANIS_ENABLE_AVX2 in cmake turns on AVX2
+#if defined(__AVX2__)
+#define CANIS_SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CANIS_SIMD_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace Canis
+{
+    inline const char *GetSimdName()
+    {
+#if defined(CANIS_SIMD_AVX2)
+        return "AVX2";
+#elif defined(CANIS_SIMD_SSE)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+} // end of Canis namespace
@@ -0,0 +1,160 @@
+#include "SpatialHash.hpp"
+#include "Debug.hpp"
+
+namespace Canis
+{
+    SpatialHash::SpatialHash(float _cellSize)
+    {
+        SetCellSize(_cellSize);
+    }
+
+    void SpatialHash::SetCellSize(float _cellSize)
+    {
+        if (GetProxyCount() != 0)
+        {
+            Warning("SpatialHash cell size can only change while it is empty");
+            return;
+        }
+
+        m_cellSize = _cellSize;
+        m_inverseCellSize = 1.0f / _cellSize;
+        m_cells.clear();
+    }
+
+    unsigned int SpatialHash::Insert(unsigned int _userId, const AABB2D &_bounds)
+    {
+        unsigned int proxy;
+
+        if (m_freeProxies.empty())
+        {
+            proxy = m_proxies.size();
+            m_proxies.push_back({});
+        }
+        else
+        {
+            proxy = m_freeProxies.back();
+            m_freeProxies.pop_back();
+        }
+
+        m_proxies[proxy].userId = _userId;
+        m_proxies[proxy].bounds = _bounds;
+        m_proxies[proxy].cell = CellCoord((_bounds.min + _bounds.max) * 0.5f);
+        m_proxies[proxy].oversized = IsOversized(_bounds);
+
+        AddToCell(proxy);
+
+        return proxy;
+    }
+
+    void SpatialHash::Update(unsigned int _proxy, const AABB2D &_bounds)
+    {
+        Proxy &p = m_proxies[_proxy];
+        p.bounds = _bounds;
+
+        glm::ivec2 cell = CellCoord((_bounds.min + _bounds.max) * 0.5f);
+        bool oversized = IsOversized(_bounds);
+
+        // the oversized list ignores the cell, so only leaving or joining it moves those
+        if (oversized == p.oversized && (oversized || cell == p.cell))
+        {
+            p.cell = cell;
+            CellOf(p).bounds.Set(p.indexInCell, _bounds);
+            return;
+        }
+
+        RemoveFromCell(_proxy);
+        m_proxies[_proxy].cell = cell;
+        m_proxies[_proxy].oversized = oversized;
+        AddToCell(_proxy);
+    }
+
+    void SpatialHash::Remove(unsigned int _proxy)
+    {
+        RemoveFromCell(_proxy);
+        m_freeProxies.push_back(_proxy);
+    }
+
+    void SpatialHash::Clear()
+    {
+        m_cells.clear();
+
+        m_oversized.proxies.clear();
+        m_oversized.bounds.Clear();
+
+        m_proxies.clear();
+        m_freeProxies.clear();
+    }
+
+    void SpatialHash::QueryAABB(const AABB2D &_bounds, std::vector<unsigned int> &_userIds) const
+    {
+        ForEachOverlap2D(_bounds, m_oversized.bounds, 0, [&](size_t _index) {
+            _userIds.push_back(m_proxies[m_oversized.proxies[_index]].userId);
+        });
+
+        // any grid proxy that can touch _bounds has its center inside the box grown by half a cell
+        glm::vec2 margin = glm::vec2(m_cellSize * 0.5f);
+        glm::ivec2 minCell = CellCoord(_bounds.min - margin);
+        glm::ivec2 maxCell = CellCoord(_bounds.max + margin);
+
+        for (int y = minCell.y; y <= maxCell.y; y++)
+        {
+            for (int x = minCell.x; x <= maxCell.x; x++)
+            {
+                auto it = m_cells.find(CellKey(x, y));
+                if (it == m_cells.end())
+                    continue;
+
+                const Cell &cell = it->second;
+
+                ForEachOverlap2D(_bounds, cell.bounds, 0, [&](size_t _index) {
+                    _userIds.push_back(m_proxies[cell.proxies[_index]].userId);
+                });
+            }
+        }
+    }
+
+    glm::ivec2 SpatialHash::CellCoord(const glm::vec2 &_point) const
+    {
+        return glm::ivec2((int)std::floor(_point.x * m_inverseCellSize), (int)std::floor(_point.y * m_inverseCellSize));
+    }
+
+    bool SpatialHash::IsOversized(const AABB2D &_bounds) const
+    {
+        glm::vec2 size = _bounds.max - _bounds.min;
+        return size.x > m_cellSize || size.y > m_cellSize;
+    }
+
+    SpatialHash::Cell &SpatialHash::CellOf(const Proxy &_proxy)
+    {
+        if (_proxy.oversized)
+            return m_oversized;
+
+        return m_cells.find(CellKey(_proxy.cell.x, _proxy.cell.y))->second;
+    }
+
+    void SpatialHash::AddToCell(unsigned int _proxy)
+    {
+        Proxy &p = m_proxies[_proxy];
+        Cell &cell = p.oversized ? m_oversized : m_cells[CellKey(p.cell.x, p.cell.y)];
+
+        p.indexInCell = cell.proxies.size();
+        cell.proxies.push_back(_proxy);
+        cell.bounds.Push(p.bounds);
+    }
+
+    void SpatialHash::RemoveFromCell(unsigned int _proxy)
+    {
+        Proxy &p = m_proxies[_proxy];
+        Cell &cell = CellOf(p);
+
+        // swap and pop both arrays, the moved proxy learns its new slot
+        unsigned int moved = cell.proxies.back();
+        cell.proxies[p.indexInCell] = moved;
+        m_proxies[moved].indexInCell = p.indexInCell;
+        cell.proxies.pop_back();
+        cell.bounds.SwapRemove(p.indexInCell);
+
+        if (!p.oversized && cell.proxies.empty())
+            m_cells.erase(CellKey(p.cell.x, p.cell.y));
+    }
+} // end of Canis namespace
@@ -0,0 +1,150 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include "Data/AABB2D.hpp"
+#include "AABBBatch.hpp"
+
+namespace Canis
+{
+    // loose uniform grid broad phase, each proxy lives in the one cell that holds its center
+    // queries grow by half a cell so nothing is missed, and because a proxy is only listed once it can be
+    // moved or removed in constant time and results never need deduplicating
+    // proxies wider or taller than a cell would need a bigger margin for everyone, so they are kept in
+    // one separate list that every query also tests
+    // only the cells in use are stored so the world has no fixed size
+    class SpatialHash
+    {
+    public:
+        static constexpr unsigned int INVALID_PROXY = ~0u;
+
+        SpatialHash(float _cellSize = 100.0f);
+
+        // only valid while the hash is empty
+        void SetCellSize(float _cellSize);
+        float GetCellSize() { return m_cellSize; }
+
+        unsigned int Insert(unsigned int _userId, const AABB2D &_bounds);
+        // cheap when the center stays in the same cell, only the stored bounds change
+        void Update(unsigned int _proxy, const AABB2D &_bounds);
+        void Remove(unsigned int _proxy);
+        void Clear();
+
+        void SetUserId(unsigned int _proxy, unsigned int _userId) { m_proxies[_proxy].userId = _userId; }
+        unsigned int GetUserId(unsigned int _proxy) const { return m_proxies[_proxy].userId; }
+        const AABB2D &GetBounds(unsigned int _proxy) const { return m_proxies[_proxy].bounds; }
+        size_t GetProxyCount() const { return m_proxies.size() - m_freeProxies.size(); }
+
+        // appends the user id of every proxy whose bounds overlap _bounds
+        void QueryAABB(const AABB2D &_bounds, std::vector<unsigned int> &_userIds) const;
+
+        // calls _callback(userIdA, userIdB) once for every pair of overlapping proxies
+        template <typename F>
+        void ForEachPair(F &&_callback) const
+        {
+            // the oversized proxies against each other and against every cell
+            for (size_t i = 0; i < m_oversized.proxies.size(); i++)
+            {
+                const AABB2D &bounds = m_oversized.bounds.Get(i);
+                unsigned int userA = m_proxies[m_oversized.proxies[i]].userId;
+
+                ForEachOverlap2D(bounds, m_oversized.bounds, i + 1, [&](size_t _j) {
+                    _callback(userA, m_proxies[m_oversized.proxies[_j]].userId);
+                });
+
+                for (auto &entry : m_cells)
+                {
+                    const Cell &cell = entry.second;
+
+                    ForEachOverlap2D(bounds, cell.bounds, 0, [&](size_t _j) {
+                        _callback(userA, m_proxies[cell.proxies[_j]].userId);
+                    });
+                }
+            }
+
+            for (auto &entry : m_cells)
+            {
+                const Cell &cell = entry.second;
+                if (cell.proxies.empty())
+                    continue;
+
+                glm::ivec2 coord = CellFromKey(entry.first);
+
+                // the batched kernel tests each box against the rest of its cell
+                for (size_t i = 0; i < cell.proxies.size(); i++)
+                {
+                    unsigned int userA = m_proxies[cell.proxies[i]].userId;
+
+                    ForEachOverlap2D(cell.bounds.Get(i), cell.bounds, i + 1, [&](size_t _j) {
+                        _callback(userA, m_proxies[cell.proxies[_j]].userId);
+                    });
+                }
+
+                // no grid proxy is bigger than a cell, so two that overlap have centers at most one cell apart
+                // only neighbours after this cell so every pair of cells is visited once
+                for (int y = 0; y <= 1; y++)
+                {
+                    for (int x = -1; x <= 1; x++)
+                    {
+                        if (y == 0 && x <= 0)
+                            continue;
+
+                        auto neighbour = m_cells.find(CellKey(coord.x + x, coord.y + y));
+                        if (neighbour == m_cells.end() || neighbour->second.proxies.empty())
+                            continue;
+
+                        const Cell &other = neighbour->second;
+
+                        for (size_t i = 0; i < cell.proxies.size(); i++)
+                        {
+                            unsigned int userA = m_proxies[cell.proxies[i]].userId;
+
+                            ForEachOverlap2D(cell.bounds.Get(i), other.bounds, 0, [&](size_t _j) {
+                                _callback(userA, m_proxies[other.proxies[_j]].userId);
+                            });
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        // bounds are kept packed next to the proxy list so the narrow stage can test a whole cell at once
+        struct Cell
+        {
+            std::vector<unsigned int> proxies = {};
+            AABBArray2D bounds = {};
+        };
+
+        struct Proxy
+        {
+            AABB2D bounds;
+            glm::ivec2 cell = glm::ivec2(0);
+            bool oversized = false;
+            unsigned int indexInCell = 0;
+            unsigned int userId = 0;
+        };
+
+        float m_cellSize = 100.0f;
+        float m_inverseCellSize = 0.01f;
+
+        std::vector<Proxy> m_proxies = {};
+        std::vector<unsigned int> m_freeProxies = {};
+
+        // a cell is erased when its last proxy leaves, so moving proxies do not grow the map
+        std::unordered_map<long long, Cell> m_cells = {};
+        Cell m_oversized = {};
+
+        glm::ivec2 CellCoord(const glm::vec2 &_point) const;
+        bool IsOversized(const AABB2D &_bounds) const;
+        // the list the proxy is in, found from its flag and cell so nothing points into the hash itself
+        Cell &CellOf(const Proxy &_proxy);
+        void AddToCell(unsigned int _proxy);
+        void RemoveFromCell(unsigned int _proxy);
+
+        static long long CellKey(int _x, int _y) { return ((long long)_x << 32) | (unsigned int)_y; }
+        static glm::ivec2 CellFromKey(long long _key) { return glm::ivec2((int)(_key >> 32), (int)(_key & 0xffffffff)); }
+    };
+} // end of Canis namespace
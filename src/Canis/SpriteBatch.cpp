@@ -0,0 +1,211 @@
+#include "SpriteBatch.hpp"
+#include "Debug.hpp"
+#include "GLState.hpp"
+
+#include <GL/glew.h>
+#include <SDL.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace Canis
+{
+    SpriteBatch::SpriteBatch()
+    {
+    }
+
+    SpriteBatch::~SpriteBatch()
+    {
+        if (m_EBO != 0)
+            glDeleteBuffers(1, &m_EBO);
+        if (m_VAO != 0)
+            glDeleteVertexArrays(1, &m_VAO);
+    }
+
+    void SpriteBatch::Init(Shader *_shader, unsigned int _maxSpritesPerDraw, SpriteBatchMode _mode)
+    {
+        m_shader = _shader;
+        m_maxSpritesPerDraw = _maxSpritesPerDraw;
+        m_mode = _mode;
+
+        // a range is flushed when its slots run out, so use every unit the fragment stage has up to the shader's array
+        m_textureSlots = 1;
+        if (m_mode == SpriteBatchMode::TEXTURE_SLOTS)
+        {
+            int units = 0;
+            glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &units);
+            m_textureSlots = std::clamp((unsigned int)units, 1u, SPRITE_BATCH_MAX_TEXTURE_SLOTS);
+        }
+
+        // samplers are program state, so the units only have to be assigned once
+        m_shader->Use();
+        if (m_mode == SpriteBatchMode::TEXTURE_ARRAY)
+            m_shader->SetInt("TEXTURE_ARRAY", 0);
+        else
+            for (unsigned int slot = 0; slot < m_textureSlots; slot++)
+                m_shader->SetInt("TEXTURES[" + std::to_string(slot) + "]", slot);
+
+        // every sprite uses the same 6 indices offset by 4 vertices so the index buffer never changes
+        std::vector<unsigned int> indices(m_maxSpritesPerDraw * 6);
+        for (unsigned int i = 0; i < m_maxSpritesPerDraw; i++)
+        {
+            indices[i * 6 + 0] = i * 4 + 0;
+            indices[i * 6 + 1] = i * 4 + 1;
+            indices[i * 6 + 2] = i * 4 + 3;
+            indices[i * 6 + 3] = i * 4 + 1;
+            indices[i * 6 + 4] = i * 4 + 2;
+            indices[i * 6 + 5] = i * 4 + 3;
+        }
+
+        glGenVertexArrays(1, &m_VAO);
+        glGenBuffers(1, &m_EBO);
+
+        GLState::BindVertexArray(m_VAO);
+
+        GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), indices.data(), GL_STATIC_DRAW);
+
+        m_vertexBuffer.Init(GL_ARRAY_BUFFER, sizeof(SpriteVertex) * m_maxSpritesPerDraw * 4);
+
+        SetupAttributes();
+
+        GLState::BindVertexArray(0);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // the vao has to point at the stream buffer again whenever it is recreated
+    void SpriteBatch::SetupAttributes()
+    {
+        GLState::BindVertexArray(m_VAO);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer.GetBufferID());
+
+        // position
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void *)offsetof(SpriteVertex, position));
+        glEnableVertexAttribArray(0);
+
+        // uv
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void *)offsetof(SpriteVertex, uv));
+        glEnableVertexAttribArray(1);
+
+        // color
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void *)offsetof(SpriteVertex, color));
+        glEnableVertexAttribArray(2);
+
+        // slot, an integer attribute so the shader can switch on it
+        glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(SpriteVertex), (void *)offsetof(SpriteVertex, slot));
+        glEnableVertexAttribArray(3);
+    }
+
+    void SpriteBatch::Begin()
+    {
+        m_vertices.clear();
+        m_ranges.clear();
+        m_rangeTextures.clear();
+        m_drawCallCount = 0;
+    }
+
+    unsigned int SpriteBatch::SlotFor(const GLTexture &_texture, unsigned int _spriteIndex)
+    {
+        if (!m_ranges.empty())
+        {
+            SpriteBatchRange &range = m_ranges.back();
+
+            for (unsigned int slot = 0; slot < range.textureCount; slot++)
+                if (m_rangeTextures[range.firstTexture + slot] == _texture.id)
+                    return m_mode == SpriteBatchMode::TEXTURE_ARRAY ? _texture.layer : slot;
+
+            // only the last range grows so its textures are always at the end of the list
+            if (range.textureCount < m_textureSlots)
+            {
+                m_rangeTextures.push_back(_texture.id);
+                return range.textureCount++;
+            }
+        }
+
+        // submission order is kept across ranges so blending stays correct
+        m_ranges.push_back({(unsigned int)m_rangeTextures.size(), 1, _spriteIndex, 0});
+        m_rangeTextures.push_back(_texture.id);
+
+        return m_mode == SpriteBatchMode::TEXTURE_ARRAY ? _texture.layer : 0;
+    }
+
+    void SpriteBatch::Draw(const glm::vec3 &_position, const glm::vec3 &_scale, const glm::vec4 &_color, const glm::vec4 &_uvRect, const GLTexture &_texture)
+    {
+        unsigned int slot = SlotFor(_texture, m_vertices.size() / 4);
+
+        m_ranges.back().spriteCount++;
+
+        glm::vec2 halfSize = glm::vec2(_scale.x, _scale.y) * 0.5f;
+
+        // same corner order as the quad in main.cpp
+        m_vertices.push_back({glm::vec3(_position.x + halfSize.x, _position.y + halfSize.y, _position.z), glm::vec2(_uvRect.x + _uvRect.z, _uvRect.y + _uvRect.w), _color, slot});
+        m_vertices.push_back({glm::vec3(_position.x + halfSize.x, _position.y - halfSize.y, _position.z), glm::vec2(_uvRect.x + _uvRect.z, _uvRect.y), _color, slot});
+        m_vertices.push_back({glm::vec3(_position.x - halfSize.x, _position.y - halfSize.y, _position.z), glm::vec2(_uvRect.x, _uvRect.y), _color, slot});
+        m_vertices.push_back({glm::vec3(_position.x - halfSize.x, _position.y + halfSize.y, _position.z), glm::vec2(_uvRect.x, _uvRect.y + _uvRect.w), _color, slot});
+    }
+
+    void SpriteBatch::Draw(const glm::mat4 &_transform, const glm::vec4 &_color, const glm::vec4 &_uvRect, const GLTexture &_texture)
+    {
+        unsigned int slot = SlotFor(_texture, m_vertices.size() / 4);
+
+        m_ranges.back().spriteCount++;
+
+        // the corners of a unit quad are the center plus or minus half of the x and y axes
+        glm::vec3 center = glm::vec3(_transform[3]);
+        glm::vec3 halfX = glm::vec3(_transform[0]) * 0.5f;
+        glm::vec3 halfY = glm::vec3(_transform[1]) * 0.5f;
+
+        m_vertices.push_back({center + halfX + halfY, glm::vec2(_uvRect.x + _uvRect.z, _uvRect.y + _uvRect.w), _color, slot});
+        m_vertices.push_back({center + halfX - halfY, glm::vec2(_uvRect.x + _uvRect.z, _uvRect.y), _color, slot});
+        m_vertices.push_back({center - halfX - halfY, glm::vec2(_uvRect.x, _uvRect.y), _color, slot});
+        m_vertices.push_back({center - halfX + halfY, glm::vec2(_uvRect.x, _uvRect.y + _uvRect.w), _color, slot});
+    }
+
+    void SpriteBatch::End()
+    {
+        if (m_vertices.empty())
+            return;
+
+        size_t size = sizeof(SpriteVertex) * m_vertices.size();
+
+        // growing to the vector's capacity keeps the regions from being recreated more often than the vector
+        if (m_vertexBuffer.Reserve(sizeof(SpriteVertex) * m_vertices.capacity()))
+            SetupAttributes();
+
+        // written straight into this frame's region, no reallocation and no wait on last frame's draws
+        memcpy(m_vertexBuffer.Map(size), m_vertices.data(), size);
+        m_vertexBuffer.Unmap();
+
+        m_baseVertex = m_vertexBuffer.GetOffset() / sizeof(SpriteVertex);
+    }
+
+    void SpriteBatch::Render()
+    {
+        if (m_ranges.empty())
+            return;
+
+        m_shader->Use();
+
+        GLState::BindVertexArray(m_VAO);
+
+        unsigned int target = m_mode == SpriteBatchMode::TEXTURE_ARRAY ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+
+        for (SpriteBatchRange &range : m_ranges)
+        {
+            // units the next range reuses with the same texture are skipped by GLState
+            for (unsigned int slot = 0; slot < range.textureCount; slot++)
+                GLState::BindTexture(slot, target, m_rangeTextures[range.firstTexture + slot]);
+
+            // ranges larger than the index buffer are split and offset with a base vertex
+            for (unsigned int drawn = 0; drawn < range.spriteCount; drawn += m_maxSpritesPerDraw)
+            {
+                unsigned int count = std::min(range.spriteCount - drawn, m_maxSpritesPerDraw);
+                glDrawElementsBaseVertex(GL_TRIANGLES, count * 6, GL_UNSIGNED_INT, 0, m_baseVertex + (range.firstSprite + drawn) * 4);
+                m_drawCallCount++;
+            }
+        }
+
+        m_vertexBuffer.Fence();
+    }
+} // end of Canis namespace
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Shader.hpp"
+#include "StreamBuffer.hpp"
+#include "Data/GLTexture.hpp"
+
+namespace Canis
+{
+    // size of the TEXTURES sampler array in sprite_batch.fs, also the least GL 3.3 guarantees per stage
+    constexpr unsigned int SPRITE_BATCH_MAX_TEXTURE_SLOTS = 16;
+
+    enum class SpriteBatchMode
+    {
+        TEXTURE_SLOTS, // each range binds up to the slot limit of 2d textures, use sprite_batch.fs
+        TEXTURE_ARRAY  // each range is one TextureArray and the slot is the layer, use sprite_batch_array.fs
+    };
+
+    struct SpriteVertex
+    {
+        glm::vec3 position;
+        glm::vec2 uv;
+        glm::vec4 color;
+        unsigned int slot; // texture unit in TEXTURE_SLOTS mode, array layer in TEXTURE_ARRAY mode
+    };
+
+    // a run of sprites that can go out in one draw call with the textures bound for it
+    struct SpriteBatchRange
+    {
+        unsigned int firstTexture = 0; // into the batch's texture list, texture i goes to unit i
+        unsigned int textureCount = 0;
+        unsigned int firstSprite = 0;
+        unsigned int spriteCount = 0;
+    };
+
+    class SpriteBatch
+    {
+    public:
+        SpriteBatch();
+        ~SpriteBatch();
+
+        // _maxSpritesPerDraw sizes the shared index buffer, bigger frames are split into several draws
+        void Init(Shader *_shader, unsigned int _maxSpritesPerDraw = 10000, SpriteBatchMode _mode = SpriteBatchMode::TEXTURE_SLOTS);
+
+        void Begin();
+        void Draw(const glm::vec3 &_position, const glm::vec3 &_scale, const glm::vec4 &_color, const glm::vec4 &_uvRect, const GLTexture &_texture);
+        // unit quad placed by a cached world matrix, for sprites that belong to a transform hierarchy
+        void Draw(const glm::mat4 &_transform, const glm::vec4 &_color, const glm::vec4 &_uvRect, const GLTexture &_texture);
+        void End();
+        // the camera comes from the FrameData uniform buffer
+        void Render();
+
+        unsigned int GetDrawCallCount() { return m_drawCallCount; }
+        unsigned int GetTextureSlotCount() { return m_textureSlots; }
+        unsigned int GetSpriteCount() { return m_vertices.size() / 4; }
+
+    private:
+        void SetupAttributes();
+        // finds or adds _texture in the last range, starting a new range when it has no free slot
+        unsigned int SlotFor(const GLTexture &_texture, unsigned int _spriteIndex);
+
+        Shader *m_shader = nullptr;
+
+        unsigned int m_VAO = 0;
+        unsigned int m_EBO = 0;
+        StreamBuffer m_vertexBuffer;
+
+        SpriteBatchMode m_mode = SpriteBatchMode::TEXTURE_SLOTS;
+        unsigned int m_textureSlots = 1;
+        unsigned int m_maxSpritesPerDraw = 0;
+        unsigned int m_baseVertex = 0; // first vertex of this frame's region in m_vertexBuffer
+        unsigned int m_drawCallCount = 0;
+
+        std::vector<SpriteVertex> m_vertices = {};
+        std::vector<SpriteBatchRange> m_ranges = {};
+        std::vector<unsigned int> m_rangeTextures = {};
+    };
+} // end of Canis namespace
@@ -0,0 +1,144 @@
+#include "StreamBuffer.hpp"
+#include "Debug.hpp"
+#include "GLState.hpp"
+
+#include <GL/glew.h>
+
+namespace Canis
+{
+    StreamBuffer::StreamBuffer()
+    {
+    }
+
+    StreamBuffer::~StreamBuffer()
+    {
+        Destroy();
+    }
+
+    void StreamBuffer::Init(unsigned int _target, size_t _regionSize)
+    {
+        m_target = _target;
+        m_regionSize = _regionSize;
+
+        // the context is 3.3 core, persistent mapping needs 4.4 or the extension
+        m_persistent = GLEW_ARB_buffer_storage;
+
+        if (!m_persistent)
+            Warning("glBufferStorage is not available, StreamBuffer falls back to orphaning");
+
+        Create();
+    }
+
+    bool StreamBuffer::Reserve(size_t _size)
+    {
+        if (_size <= m_regionSize)
+            return false;
+
+        m_regionSize = _size;
+
+        Destroy();
+        Create();
+
+        return true;
+    }
+
+    void *StreamBuffer::Map(size_t _size)
+    {
+        if (_size > m_regionSize)
+        {
+            Error("StreamBuffer::Map asked for more than a region, call Reserve first");
+            return nullptr;
+        }
+
+        if (!m_persistent)
+        {
+            GLState::BindBuffer(m_target, m_buffer);
+            glBufferData(m_target, m_regionSize, nullptr, GL_STREAM_DRAW);
+            return glMapBufferRange(m_target, 0, _size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        }
+
+        GLsync fence = (GLsync)m_fences[m_region];
+
+        if (fence != nullptr)
+        {
+            // only blocks when the gpu is still reading this region from REGION_COUNT frames ago
+            GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            while (true)
+            {
+                GLenum result = glClientWaitSync(fence, flags, 1000000);
+                if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+                    break;
+                flags = 0;
+            }
+
+            glDeleteSync(fence);
+            m_fences[m_region] = nullptr;
+        }
+
+        return m_mapped + GetOffset();
+    }
+
+    void StreamBuffer::Unmap()
+    {
+        // coherent mappings are seen by the gpu without unmapping or flushing
+        if (m_persistent)
+            return;
+
+        GLState::BindBuffer(m_target, m_buffer);
+        glUnmapBuffer(m_target);
+    }
+
+    void StreamBuffer::Fence()
+    {
+        if (!m_persistent)
+            return;
+
+        if (m_fences[m_region] != nullptr)
+            glDeleteSync((GLsync)m_fences[m_region]);
+
+        m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_region = (m_region + 1) % REGION_COUNT;
+    }
+
+    void StreamBuffer::Create()
+    {
+        glGenBuffers(1, &m_buffer);
+        GLState::BindBuffer(m_target, m_buffer);
+
+        if (!m_persistent)
+        {
+            glBufferData(m_target, m_regionSize, nullptr, GL_STREAM_DRAW);
+            return;
+        }
+
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(m_target, m_regionSize * REGION_COUNT, nullptr, flags);
+        m_mapped = (char *)glMapBufferRange(m_target, 0, m_regionSize * REGION_COUNT, flags);
+        m_region = 0;
+    }
+
+    void StreamBuffer::Destroy()
+    {
+        for (void *&fence : m_fences)
+        {
+            if (fence != nullptr)
+                glDeleteSync((GLsync)fence);
+            fence = nullptr;
+        }
+
+        if (m_buffer == 0)
+            return;
+
+        // draws already issued from the old buffer still finish, gl keeps it alive until they do
+        GLState::BindBuffer(m_target, m_buffer);
+        if (m_mapped != nullptr)
+            glUnmapBuffer(m_target);
+
+        // unbind through GLState so it does not keep the deleted name as bound
+        GLState::BindBuffer(m_target, 0);
+        glDeleteBuffers(1, &m_buffer);
+
+        m_buffer = 0;
+        m_mapped = nullptr;
+    }
+} // end of Canis namespace
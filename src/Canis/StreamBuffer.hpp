@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+
+namespace Canis
+{
+    // a buffer for data that is rewritten every frame, split into regions the cpu and gpu take turns on
+    // with glBufferStorage the buffer stays mapped and each region is fenced so a write only waits
+    // when the gpu is still REGION_COUNT frames behind, without it the whole buffer is orphaned per frame
+    class StreamBuffer
+    {
+    public:
+        static constexpr unsigned int REGION_COUNT = 3;
+
+        StreamBuffer();
+        ~StreamBuffer();
+
+        void Init(unsigned int _target, size_t _regionSize);
+
+        // grows the regions to exactly _size bytes, pass room to spare so it does not happen every frame
+        // true when that created a new buffer object and anything pointing at the old one, like a vao, has to be set up again
+        bool Reserve(size_t _size);
+
+        // returns _size writable bytes at GetOffset, _size has to fit the region set by Init or Reserve
+        // keep the region size a multiple of the element size so the offset can be used as a base vertex
+        void *Map(size_t _size);
+        void Unmap();
+        // call once the draws reading the mapped region have been issued, the next Map moves on to the next region
+        void Fence();
+
+        unsigned int GetBufferID() { return m_buffer; }
+        size_t GetOffset() { return m_region * m_regionSize; }
+        size_t GetRegionSize() { return m_regionSize; }
+        bool IsPersistent() { return m_persistent; }
+
+    private:
+        void Create();
+        void Destroy();
+
+        unsigned int m_target = 0;
+        unsigned int m_buffer = 0;
+        size_t m_regionSize = 0;
+        unsigned int m_region = 0;
+        bool m_persistent = false;
+        char *m_mapped = nullptr;
+        void *m_fences[REGION_COUNT] = {}; // GLsync, kept opaque so this header does not need glew
+    };
+} // end of Canis namespace
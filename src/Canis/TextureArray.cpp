@@ -0,0 +1,84 @@
+#include "TextureArray.hpp"
+#include "Debug.hpp"
+#include "GLState.hpp"
+#include "IOManager.hpp"
+
+#include <GL/glew.h>
+
+namespace Canis
+{
+    bool TextureArray::Add(const std::string &_path)
+    {
+        if (m_layerIndex.count(_path) != 0)
+            return true;
+
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> pixels;
+
+        if (!LoadImagePixels(_path, width, height, pixels))
+            return false;
+
+        if (!m_layers.empty() && (width != m_width || height != m_height))
+        {
+            Error("TextureArray image " + _path + " is " + std::to_string(width) + "x" + std::to_string(height) +
+                  ", the array is " + std::to_string(m_width) + "x" + std::to_string(m_height));
+            return false;
+        }
+
+        m_width = width;
+        m_height = height;
+        m_layerIndex[_path] = m_layers.size();
+        m_layers.push_back(std::move(pixels));
+        return true;
+    }
+
+    GLTexture TextureArray::Build(bool _wrap)
+    {
+        m_texture = {};
+
+        if (m_layers.empty())
+            return m_texture;
+
+        m_texture.width = m_width;
+        m_texture.height = m_height;
+
+        glGenTextures(1, &m_texture.id);
+        GLState::BindTexture(GL_TEXTURE_2D_ARRAY, m_texture.id);
+
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, m_width, m_height, m_layers.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        for (size_t layer = 0; layer < m_layers.size(); layer++)
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_width, m_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, m_layers[layer].data());
+
+        // layers are filtered on their own, unlike an atlas the mips never mix neighbouring images
+        GLint wrap = _wrap ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, wrap);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, wrap);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+        GLState::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        m_layers.clear();
+
+        return m_texture;
+    }
+
+    GLTexture TextureArray::GetTexture(const std::string &_path) const
+    {
+        GLTexture texture = m_texture;
+
+        auto it = m_layerIndex.find(_path);
+        if (it == m_layerIndex.end())
+        {
+            Error("TextureArray has no image " + _path);
+            return texture;
+        }
+
+        texture.layer = it->second;
+        return texture;
+    }
+} // end of Canis namespace
@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Data/GLTexture.hpp"
+
+namespace Canis
+{
+    // stacks images of the same size into one GL_TEXTURE_2D_ARRAY, each image is a layer
+    // sprites drawn with GetTexture share the array id, so a SpriteBatch in TEXTURE_ARRAY mode
+    // keeps all of them in one range no matter how many images there are
+    class TextureArray
+    {
+    public:
+        // the first image sets the size, later ones that do not match it are rejected
+        bool Add(const std::string &_path);
+
+        // uploads every added image as a layer, call once after the last Add, the cpu copies are freed afterwards
+        GLTexture Build(bool _wrap = false);
+
+        // the array texture with layer set to the image loaded from _path
+        GLTexture GetTexture(const std::string &_path) const;
+
+    private:
+        int m_width = 0;
+        int m_height = 0;
+        std::vector<std::vector<unsigned char>> m_layers = {};
+        std::unordered_map<std::string, unsigned int> m_layerIndex = {};
+        GLTexture m_texture = {};
+    };
+} // end of Canis namespace
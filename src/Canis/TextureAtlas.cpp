@@ -0,0 +1,234 @@
+#include "TextureAtlas.hpp"
+#include "Debug.hpp"
+#include "GLState.hpp"
+#include "IOManager.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace Canis
+{
+    bool TextureAtlas::Add(const std::string &_path)
+    {
+        Image image;
+        image.path = _path;
+
+        if (!LoadImagePixels(_path, image.width, image.height, image.pixels))
+            return false;
+
+        m_images.push_back(std::move(image));
+        return true;
+    }
+
+    GLTexture TextureAtlas::Build(int _padding)
+    {
+        m_texture = {};
+        m_uvs.clear();
+
+        if (m_images.empty())
+            return m_texture;
+
+        // the padding only protects a mip level whose texel blocks line up with the images,
+        // so it is rounded down to a power of two and every image starts on a multiple of it
+        int padding = 0;
+        int maxLevel = 0;
+        if (_padding > 0)
+        {
+            padding = 1;
+            while (padding * 2 <= _padding)
+            {
+                padding *= 2;
+                maxLevel++;
+            }
+        }
+        int alignment = std::max(padding, 1);
+
+        int maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+
+        // tall images first keeps the skyline flat
+        std::sort(m_images.begin(), m_images.end(), [](const Image &_a, const Image &_b) {
+            return _a.height != _b.height ? _a.height > _b.height : _a.width > _b.width;
+        });
+
+        long long area = 0;
+        for (const Image &image : m_images)
+            area += (long long)(image.width + padding * 2) * (image.height + padding * 2);
+
+        // start at the smallest power of two square that could hold the area and grow one side at a time
+        int width = 1;
+        int height = 1;
+        while ((long long)width * height < area)
+        {
+            if (width <= height)
+                width *= 2;
+            else
+                height *= 2;
+        }
+
+        // the area alone can already ask for more than the driver allows, so the size is checked before every Pack
+        while (true)
+        {
+            if (width > maxSize || height > maxSize)
+            {
+                Error("TextureAtlas images do not fit in a " + std::to_string(maxSize) + " texture");
+                return m_texture;
+            }
+
+            if (Pack(width, height, padding, alignment))
+                break;
+
+            if (width <= height)
+                width *= 2;
+            else
+                height *= 2;
+        }
+
+        // copy each image in and extrude its edge pixels out through the padding
+        std::vector<unsigned char> pixels((size_t)width * height * 4, 0);
+
+        for (const Image &image : m_images)
+        {
+            for (int y = -padding; y < image.height + padding; y++)
+            {
+                int sourceY = std::clamp(y, 0, image.height - 1);
+
+                for (int x = -padding; x < image.width + padding; x++)
+                {
+                    int sourceX = std::clamp(x, 0, image.width - 1);
+
+                    const unsigned char *source = &image.pixels[((size_t)sourceY * image.width + sourceX) * 4];
+                    unsigned char *destination = &pixels[((size_t)(image.y + y) * width + image.x + x) * 4];
+                    memcpy(destination, source, 4);
+                }
+            }
+
+            m_uvs[image.path] = glm::vec4(
+                (float)image.x / width,
+                (float)image.y / height,
+                (float)image.width / width,
+                (float)image.height / height);
+        }
+
+        m_texture.width = width;
+        m_texture.height = height;
+
+        glGenTextures(1, &m_texture.id);
+        GLState::BindTexture(GL_TEXTURE_2D, m_texture.id);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        // coarser levels would average neighbouring images together
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        GLState::BindTexture(GL_TEXTURE_2D, 0);
+
+        m_images.clear();
+
+        return m_texture;
+    }
+
+    glm::vec4 TextureAtlas::GetUV(const std::string &_path) const
+    {
+        auto it = m_uvs.find(_path);
+
+        if (it == m_uvs.end())
+        {
+            Error("TextureAtlas has no image " + _path);
+            return glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        }
+
+        return it->second;
+    }
+
+    bool TextureAtlas::Pack(int _width, int _height, int _padding, int _alignment)
+    {
+        std::vector<SkylineNode> skyline = {{0, 0, _width}};
+
+        for (Image &image : m_images)
+        {
+            // rounding the padded size keeps every node, and so every image, on the alignment
+            int width = (image.width + _padding * 2 + _alignment - 1) / _alignment * _alignment;
+            int height = (image.height + _padding * 2 + _alignment - 1) / _alignment * _alignment;
+
+            // bottom left rule, the lowest spot and then the leftmost
+            int bestNode = -1;
+            int bestX = 0;
+            int bestY = INT_MAX;
+
+            for (size_t i = 0; i < skyline.size(); i++)
+            {
+                int x = skyline[i].x;
+                if (x + width > _width)
+                    break;
+
+                // the rect rests on the highest node it spans
+                int y = 0;
+                int spanned = 0;
+                for (size_t j = i; spanned < width; j++)
+                {
+                    y = std::max(y, skyline[j].y);
+                    spanned = skyline[j].x + skyline[j].width - x;
+                }
+
+                if (y + height <= _height && y < bestY)
+                {
+                    bestNode = (int)i;
+                    bestX = x;
+                    bestY = y;
+                }
+            }
+
+            if (bestNode < 0)
+                return false;
+
+            image.x = bestX + _padding;
+            image.y = bestY + _padding;
+
+            // the new node covers the rect, the nodes under it are cut back or removed
+            skyline.insert(skyline.begin() + bestNode, {bestX, bestY + height, width});
+
+            int right = bestX + width;
+            size_t next = bestNode + 1;
+            while (next < skyline.size() && skyline[next].x < right)
+            {
+                int nodeRight = skyline[next].x + skyline[next].width;
+
+                if (nodeRight <= right)
+                {
+                    skyline.erase(skyline.begin() + next);
+                    continue;
+                }
+
+                skyline[next].width = nodeRight - right;
+                skyline[next].x = right;
+                break;
+            }
+
+            // neighbours at the same height are one step
+            for (size_t i = 0; i + 1 < skyline.size();)
+            {
+                if (skyline[i].y == skyline[i + 1].y)
+                {
+                    skyline[i].width += skyline[i + 1].width;
+                    skyline.erase(skyline.begin() + i + 1);
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+
+        return true;
+    }
+} // end of Canis namespace
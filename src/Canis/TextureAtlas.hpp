@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Data/GLTexture.hpp"
+
+namespace Canis
+{
+    // packs many images into one texture at load time so sprites using any of them share a batch
+    // images are placed with a skyline packer and surrounded by a copy of their own edge pixels,
+    // so linear filtering and the mip levels up to log2(padding) never pull in a neighbour
+    // sprites drawn from an atlas can not use GL_REPEAT, the uv rect already picks the sub image
+    class TextureAtlas
+    {
+    public:
+        // loads the pixels now and keeps them on the cpu until Build, the path is also the name for GetUV
+        bool Add(const std::string &_path);
+
+        // packs and uploads everything added so far, the cpu copies are freed afterwards
+        // fails with an empty texture when the images do not fit in GL_MAX_TEXTURE_SIZE
+        GLTexture Build(int _padding = 4);
+
+        // x, y offset and width, height in texture space, same layout as Entity::uv
+        glm::vec4 GetUV(const std::string &_path) const;
+        const GLTexture &GetTexture() const { return m_texture; }
+
+    private:
+        struct Image
+        {
+            std::string path;
+            int width = 0;
+            int height = 0;
+            std::vector<unsigned char> pixels = {}; // rgba rows, bottom up like LoadImageGL
+            int x = 0;
+            int y = 0;
+        };
+
+        // one step of the skyline, the packed area below y is taken from x to x + width
+        struct SkylineNode
+        {
+            int x = 0;
+            int y = 0;
+            int width = 0;
+        };
+
+        bool Pack(int _width, int _height, int _padding, int _alignment);
+
+        std::vector<Image> m_images = {};
+        std::unordered_map<std::string, glm::vec4> m_uvs = {};
+        GLTexture m_texture = {};
+    };
+} // end of Canis namespace
@@ -0,0 +1,264 @@
+#include "TransformPool.hpp"
+#include "Debug.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Canis
+{
+    unsigned int TransformPool::Create(const glm::vec3 &_position, const glm::vec3 &_scale)
+    {
+        unsigned int id;
+
+        if (m_freeIds.empty())
+        {
+            id = m_dense.size();
+            m_dense.push_back(INVALID_TRANSFORM);
+        }
+        else
+        {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+        }
+
+        m_dense[id] = m_ids.size();
+
+        // a new root can go at the end without breaking the parent before child order
+        m_position.push_back(_position);
+        m_scale.push_back(_scale);
+        m_world.push_back(glm::mat4(1.0f));
+        m_parent.push_back(INVALID_TRANSFORM);
+        m_childCount.push_back(0);
+        m_dirty.push_back(1);
+        m_ids.push_back(id);
+
+        return id;
+    }
+
+    void TransformPool::Destroy(unsigned int _id)
+    {
+        unsigned int row = m_dense[_id];
+        unsigned int last = m_ids.size() - 1;
+
+        if (m_parent[row] != INVALID_TRANSFORM)
+        {
+            m_childCount[m_parent[row]]--;
+            m_parentedCount--;
+        }
+
+        // only walk the rows when someone points at the removed or the moved row
+        if (m_childCount[row] > 0 || (row != last && m_childCount[last] > 0))
+        {
+            for (unsigned int i = 0; i < m_ids.size(); i++)
+            {
+                if (m_parent[i] == row)
+                {
+                    m_parent[i] = INVALID_TRANSFORM;
+                    m_dirty[i] = 1;
+                    m_parentedCount--;
+                }
+                else if (m_parent[i] == last)
+                {
+                    m_parent[i] = row;
+
+                    // a child sitting before the new row of its parent breaks the order
+                    if (i < row)
+                        m_orderDirty = true;
+                }
+            }
+        }
+
+        if (row != last)
+        {
+            m_position[row] = m_position[last];
+            m_scale[row] = m_scale[last];
+            m_world[row] = m_world[last];
+            m_parent[row] = m_parent[last];
+            m_childCount[row] = m_childCount[last];
+            m_dirty[row] = m_dirty[last];
+            m_ids[row] = m_ids[last];
+            m_dense[m_ids[row]] = row;
+
+            if (m_parent[row] != INVALID_TRANSFORM && m_parent[row] > row)
+                m_orderDirty = true;
+        }
+
+        m_position.pop_back();
+        m_scale.pop_back();
+        m_world.pop_back();
+        m_parent.pop_back();
+        m_childCount.pop_back();
+        m_dirty.pop_back();
+        m_ids.pop_back();
+
+        m_dense[_id] = INVALID_TRANSFORM;
+        m_freeIds.push_back(_id);
+    }
+
+    void TransformPool::Clear()
+    {
+        m_position.clear();
+        m_scale.clear();
+        m_world.clear();
+        m_parent.clear();
+        m_childCount.clear();
+        m_dirty.clear();
+        m_ids.clear();
+        m_dense.clear();
+        m_freeIds.clear();
+        m_orderDirty = false;
+        m_parentedCount = 0;
+    }
+
+    void TransformPool::SetParent(unsigned int _id, unsigned int _parent)
+    {
+        unsigned int row = m_dense[_id];
+        unsigned int parentRow = _parent == INVALID_TRANSFORM ? INVALID_TRANSFORM : m_dense[_parent];
+
+        for (unsigned int ancestor = parentRow; ancestor != INVALID_TRANSFORM; ancestor = m_parent[ancestor])
+        {
+            if (ancestor == row)
+            {
+                Warning("TransformPool can not parent a transform to itself or one of its children");
+                return;
+            }
+        }
+
+        if (m_parent[row] != INVALID_TRANSFORM)
+        {
+            m_childCount[m_parent[row]]--;
+            m_parentedCount--;
+        }
+
+        m_parent[row] = parentRow;
+        m_dirty[row] = 1;
+
+        if (parentRow != INVALID_TRANSFORM)
+        {
+            m_childCount[parentRow]++;
+            m_parentedCount++;
+
+            if (parentRow > row)
+                m_orderDirty = true;
+        }
+    }
+
+    unsigned int TransformPool::GetParent(unsigned int _id) const
+    {
+        unsigned int parentRow = m_parent[m_dense[_id]];
+        return parentRow == INVALID_TRANSFORM ? INVALID_TRANSFORM : m_ids[parentRow];
+    }
+
+    void TransformPool::SetLocal(unsigned int _id, const glm::vec3 &_position, const glm::vec3 &_scale)
+    {
+        unsigned int row = m_dense[_id];
+
+        if (m_position[row] == _position && m_scale[row] == _scale)
+            return;
+
+        m_position[row] = _position;
+        m_scale[row] = _scale;
+        m_dirty[row] = 1;
+    }
+
+    void TransformPool::Update()
+    {
+        if (m_orderDirty)
+            SortByDepth();
+
+        m_rebuiltCount = 0;
+        size_t count = m_ids.size();
+
+        for (size_t i = 0; i < count; i++)
+        {
+            unsigned int parent = m_parent[i];
+
+            // parents were handled earlier in the pass, a rebuilt parent drags its children along
+            if (!m_dirty[i])
+            {
+                if (parent == INVALID_TRANSFORM || !m_dirty[parent])
+                    continue;
+
+                m_dirty[i] = 1;
+            }
+
+            // translate times scale written out directly instead of going through glm::translate and glm::scale
+            const glm::vec3 &p = m_position[i];
+            const glm::vec3 &s = m_scale[i];
+            glm::mat4 local = glm::mat4(s.x, 0.0f, 0.0f, 0.0f,
+                                        0.0f, s.y, 0.0f, 0.0f,
+                                        0.0f, 0.0f, s.z, 0.0f,
+                                        p.x, p.y, p.z, 1.0f);
+
+            m_world[i] = parent == INVALID_TRANSFORM ? local : m_world[parent] * local;
+            m_rebuiltCount++;
+        }
+
+        std::fill(m_dirty.begin(), m_dirty.end(), 0);
+    }
+
+    void TransformPool::SortByDepth()
+    {
+        size_t count = m_ids.size();
+        std::vector<unsigned int> depth(count, INVALID_TRANSFORM);
+        std::vector<unsigned int> chain;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            // climb until a row with a known depth or a root, then fill the depths in on the way back
+            unsigned int row = i;
+            chain.clear();
+
+            while (depth[row] == INVALID_TRANSFORM && m_parent[row] != INVALID_TRANSFORM)
+            {
+                chain.push_back(row);
+                row = m_parent[row];
+            }
+
+            if (depth[row] == INVALID_TRANSFORM)
+                depth[row] = 0;
+
+            for (size_t c = chain.size(); c-- > 0;)
+                depth[chain[c]] = depth[m_parent[chain[c]]] + 1;
+        }
+
+        std::vector<unsigned int> order(count);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](unsigned int _a, unsigned int _b) { return depth[_a] < depth[_b]; });
+
+        std::vector<unsigned int> newRow(count);
+        for (size_t i = 0; i < count; i++)
+            newRow[order[i]] = i;
+
+        std::vector<glm::vec3> position(count);
+        std::vector<glm::vec3> scale(count);
+        std::vector<glm::mat4> world(count);
+        std::vector<unsigned int> parent(count);
+        std::vector<unsigned int> childCount(count);
+        std::vector<unsigned char> dirty(count);
+        std::vector<unsigned int> ids(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            unsigned int from = order[i];
+            position[i] = m_position[from];
+            scale[i] = m_scale[from];
+            world[i] = m_world[from];
+            parent[i] = m_parent[from] == INVALID_TRANSFORM ? INVALID_TRANSFORM : newRow[m_parent[from]];
+            childCount[i] = m_childCount[from];
+            dirty[i] = m_dirty[from];
+            ids[i] = m_ids[from];
+            m_dense[ids[i]] = i;
+        }
+
+        m_position.swap(position);
+        m_scale.swap(scale);
+        m_world.swap(world);
+        m_parent.swap(parent);
+        m_childCount.swap(childCount);
+        m_dirty.swap(dirty);
+        m_ids.swap(ids);
+
+        m_orderDirty = false;
+    }
+} // end of Canis namespace
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Canis
+{
+    // local position and scale with an optional parent, world matrices are cached and only rebuilt for
+    // transforms that changed or whose parent changed
+    // storage is dense and kept sorted so parents come before their children, Update is one forward pass
+    // ids stay valid while the dense rows move around underneath them
+    class TransformPool
+    {
+    public:
+        static constexpr unsigned int INVALID_TRANSFORM = ~0u;
+
+        unsigned int Create(const glm::vec3 &_position = glm::vec3(0.0f), const glm::vec3 &_scale = glm::vec3(1.0f));
+        // children are detached and keep their local values
+        void Destroy(unsigned int _id);
+        void Clear();
+
+        // _parent may be INVALID_TRANSFORM to detach, parenting to a descendant is refused
+        void SetParent(unsigned int _id, unsigned int _parent);
+        unsigned int GetParent(unsigned int _id) const;
+        bool HasParents() const { return m_parentedCount > 0; }
+
+        // marks the transform dirty only when a value actually changed
+        void SetLocal(unsigned int _id, const glm::vec3 &_position, const glm::vec3 &_scale);
+        const glm::vec3 &GetLocalPosition(unsigned int _id) const { return m_position[m_dense[_id]]; }
+        const glm::vec3 &GetLocalScale(unsigned int _id) const { return m_scale[m_dense[_id]]; }
+
+        // valid after Update
+        const glm::mat4 &GetWorldMatrix(unsigned int _id) const { return m_world[m_dense[_id]]; }
+        glm::vec3 GetWorldPosition(unsigned int _id) const { return glm::vec3(m_world[m_dense[_id]][3]); }
+
+        // rebuilds the world matrix of every dirty transform and everything below it
+        void Update();
+
+        size_t GetCount() const { return m_ids.size(); }
+        unsigned int GetRebuiltCount() const { return m_rebuiltCount; } // matrices rebuilt by the last Update
+
+    private:
+        // dense rows, parents always sit before their children once sorted
+        std::vector<glm::vec3> m_position = {};
+        std::vector<glm::vec3> m_scale = {};
+        std::vector<glm::mat4> m_world = {};
+        std::vector<unsigned int> m_parent = {}; // dense row of the parent
+        std::vector<unsigned int> m_childCount = {};
+        std::vector<unsigned char> m_dirty = {};
+        std::vector<unsigned int> m_ids = {};
+
+        // indexed by id
+        std::vector<unsigned int> m_dense = {};
+        std::vector<unsigned int> m_freeIds = {};
+
+        bool m_orderDirty = false;
+        unsigned int m_parentedCount = 0;
+        unsigned int m_rebuiltCount = 0;
+
+        void SortByDepth();
+    };
+} // end of Canis namespace
@@ -0,0 +1,23 @@
+#include "VertexLayout.hpp"
+
+#include <GL/glew.h>
+
+namespace Canis
+{
+    VertexLayout &VertexLayout::Add(unsigned int _location, int _components, unsigned int _type, bool _normalized, unsigned int _size)
+    {
+        m_attributes.push_back({_location, _components, _type, _normalized, m_stride});
+        m_stride += _size;
+        return *this;
+    }
+
+    void VertexLayout::Apply() const
+    {
+        for (const VertexAttribute &attribute : m_attributes)
+        {
+            glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized ? GL_TRUE : GL_FALSE,
+                                  m_stride, (void *)(size_t)attribute.offset);
+            glEnableVertexAttribArray(attribute.location);
+        }
+    }
+} // end of Canis namespace
@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+
+namespace Canis
+{
+    struct VertexAttribute
+    {
+        unsigned int location = 0;
+        int components = 0;
+        unsigned int type = 0; // GL_FLOAT, GL_HALF_FLOAT, GL_UNSIGNED_SHORT, GL_INT_2_10_10_10_REV, ...
+        bool normalized = false;
+        unsigned int offset = 0;
+    };
+
+    // describes one interleaved vertex, the glVertexAttribPointer calls are generated from it
+    class VertexLayout
+    {
+    public:
+        // _size is the bytes the attribute takes in the vertex, pass more than it needs to keep the next one aligned
+        VertexLayout &Add(unsigned int _location, int _components, unsigned int _type, bool _normalized, unsigned int _size);
+
+        // points the bound vao's attributes at the bound GL_ARRAY_BUFFER
+        void Apply() const;
+
+        unsigned int GetStride() const { return m_stride; }
+        const std::vector<VertexAttribute> &GetAttributes() const { return m_attributes; }
+
+    private:
+        std::vector<VertexAttribute> m_attributes = {};
+        unsigned int m_stride = 0;
+    };
+} // end of Canis namespace
@@ -1,5 +1,6 @@
 #include "Window.hpp"
 #include "Debug.hpp"
+#include "GLState.hpp"
 #include <SDL.h>
 #include <GL/glew.h>
 
@@ -115,8 +116,8 @@ namespace Canis
         SDL_GL_SetSwapInterval(0);
 
         // Enable alpha blending
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::SetBlend(true);
+        GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         return 0;
     }
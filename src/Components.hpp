@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Canis/Data/GLTexture.hpp"
+#include "Canis/SpatialHash.hpp"
+
+enum ComponentTag : unsigned int {
+    TAG_NONE    = 0u,
+    TAG_BALL    = 1u,
+    TAG_PADDLE  = 2u,
+};
+
+// structure of arrays storage, row i of every vector belongs to the same entity
+// systems walk these linearly instead of chasing Entity pointers
+struct ComponentPools {
+    // transform
+    std::vector<glm::vec3> position = {};
+    std::vector<glm::vec3> previousPosition = {}; // position at the start of the last fixed tick
+    std::vector<glm::vec3> scale = {};
+
+    // movement
+    std::vector<glm::vec2> direction = {};
+    std::vector<float> speed = {};
+
+    // render
+    std::vector<glm::vec4> color = {};
+    std::vector<glm::vec4> uv = {};
+    std::vector<Canis::GLTexture> texture = {};
+
+    // gameplay
+    std::vector<unsigned int> tag = {};
+    std::vector<glm::uvec2> inputKeys = {}; // up and down scancodes, 0 when not player controlled
+
+    // broad phase
+    std::vector<unsigned int> proxy = {};
+
+    size_t Count() const { return position.size(); }
+
+    size_t Add() {
+        position.push_back(glm::vec3(0.0f));
+        previousPosition.push_back(glm::vec3(0.0f));
+        scale.push_back(glm::vec3(1.0f));
+        direction.push_back(glm::vec2(0.0f));
+        speed.push_back(0.0f);
+        color.push_back(glm::vec4(1.0f));
+        uv.push_back(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+        texture.push_back({});
+        tag.push_back(TAG_NONE);
+        inputKeys.push_back(glm::uvec2(0u));
+        proxy.push_back(Canis::SpatialHash::INVALID_PROXY);
+        return position.size() - 1;
+    }
+
+    Canis::AABB2D Bounds2D(size_t _row) const {
+        glm::vec2 half = glm::vec2(scale[_row].x, scale[_row].y) * 0.5f;
+        glm::vec2 center = glm::vec2(position[_row].x, position[_row].y);
+        return {center - half, center + half};
+    }
+
+    // swap and pop, the last row moves into _row
+    // use World::RemoveRow so the broad phase follows the move
+    void Remove(size_t _row) {
+        size_t last = Count() - 1;
+
+        if (_row != last)
+        {
+            position[_row] = position[last];
+            previousPosition[_row] = previousPosition[last];
+            scale[_row] = scale[last];
+            direction[_row] = direction[last];
+            speed[_row] = speed[last];
+            color[_row] = color[last];
+            uv[_row] = uv[last];
+            texture[_row] = texture[last];
+            tag[_row] = tag[last];
+            inputKeys[_row] = inputKeys[last];
+            proxy[_row] = proxy[last];
+        }
+
+        position.pop_back();
+        previousPosition.pop_back();
+        scale.pop_back();
+        direction.pop_back();
+        speed.pop_back();
+        color.pop_back();
+        uv.pop_back();
+        texture.pop_back();
+        tag.pop_back();
+        inputKeys.pop_back();
+        proxy.pop_back();
+    }
+
+    void Reserve(size_t _count) {
+        position.reserve(_count);
+        previousPosition.reserve(_count);
+        scale.reserve(_count);
+        direction.reserve(_count);
+        speed.reserve(_count);
+        color.reserve(_count);
+        uv.reserve(_count);
+        texture.reserve(_count);
+        tag.reserve(_count);
+        inputKeys.reserve(_count);
+        proxy.reserve(_count);
+    }
+
+    void Clear() {
+        position.clear();
+        previousPosition.clear();
+        scale.clear();
+        direction.clear();
+        speed.clear();
+        color.clear();
+        uv.clear();
+        texture.clear();
+        tag.clear();
+        inputKeys.clear();
+        proxy.clear();
+    }
+};
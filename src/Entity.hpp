@@ -3,31 +3,63 @@
 #include "Canis/Debug.hpp"
 #include "Canis/Shader.hpp"
 #include "Canis/Window.hpp"
-#include "Canis/InputManager.hpp"
+#include "Canis/InputSource.hpp"
 #include "Canis/Data/GLTexture.hpp"
+#include "Canis/SpatialHash.hpp"
+#include "Canis/TransformPool.hpp"
+#include "Canis/RenderQueue.hpp"
 
 class World;
 
+// stable reference to an entity, goes stale instead of dangling once the entity is destroyed
+struct EntityHandle {
+    unsigned int index = ~0u;
+    unsigned int generation = 0;
+
+    bool operator==(const EntityHandle &_other) const { return index == _other.index && generation == _other.generation; }
+    bool operator!=(const EntityHandle &_other) const { return !(*this == _other); }
+};
+
 class Entity {
 public:
+    EntityHandle        handle;
+    unsigned int        transform = Canis::TransformPool::INVALID_TRANSFORM;
     std::string         name;
-    glm::vec3           position;
+    glm::vec3           position; // relative to the parent transform when the entity has one
+    glm::vec3           previousPosition; // position at the start of the last fixed tick
     glm::vec3           scale;
     Canis::Shader       shader;
     Canis::GLTexture    texture;
-    glm::vec4           color;
+    glm::vec4           color = glm::vec4(1.0f);
+    glm::vec4           uv = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); // x, y offset and width, height in texture space
+    unsigned int        layer = 0; // drawn before every higher layer, up to RenderQueue::MAX_LAYER
+    bool                translucent = true; // sprite textures carry alpha, turn off for solid ones to skip blending
 
     World *world = nullptr;
-    Canis::Window *window = nullptr;
-    Canis::InputManager *inputManager = nullptr;
+    Canis::Window *window = nullptr; // nullptr in a headless world, use World::GetViewportSize for the play area
+    Canis::InputSource *input = nullptr;
+
+    virtual ~Entity() {}
+
+    // moves the entity without interpolating across the jump, for placing after Instantiate and respawns
+    void Teleport(const glm::vec3 &_position) {
+        position = _position;
+        previousPosition = _position;
+    }
 
     virtual void Start() {}
+    // runs on a job worker before any Update, may only change this entity and read the rest of the world
+    virtual void ParallelUpdate(float _dt) {}
+    // runs on the main thread, free to touch other entities, instantiate and destroy
     virtual void Update(float _dt) {}
-    virtual void Draw() {}
+    // submit draws instead of issuing them, the queue sorts the whole frame before anything reaches gl
+    virtual void Draw(Canis::RenderQueue &_queue) {}
     virtual void OnDestroy() {}
 private:
 };
 
+// both of these read position as world space, which only holds for entities without a parent
+// World::GetBounds2D goes through the parent's transform
 static bool EntityOverlap2D(const Entity& a, const Entity& b) {
     float aHalfWidth = a.scale.x * 0.5f;
     float aHalfHeight = a.scale.y * 0.5f;
@@ -38,4 +70,10 @@ static bool EntityOverlap2D(const Entity& a, const Entity& b) {
     bool overlapY = std::abs(a.position.y - b.position.y) <= (aHalfHeight + bHalfHeight);
 
     return overlapX && overlapY;
-}
\ No newline at end of file
+}
+
+static Canis::AABB2D EntityBounds2D(const Entity& e) {
+    glm::vec2 half = glm::vec2(e.scale.x, e.scale.y) * 0.5f;
+    glm::vec2 center = glm::vec2(e.position.x, e.position.y);
+    return {center - half, center + half};
+}
@@ -0,0 +1,130 @@
+#include "Headless.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "Ball.hpp"
+#include "Paddle.hpp"
+#include "World.hpp"
+
+using namespace glm;
+
+namespace
+{
+    uint32_t FloatBits(float _value) {
+        uint32_t bits;
+        std::memcpy(&bits, &_value, sizeof(bits));
+        return bits;
+    }
+
+    // holds the keys that move _paddle toward the ball
+    void DrivePaddle(Canis::ScriptedInput &_input, const Paddle &_paddle, const Ball &_ball, unsigned int _upKey, unsigned int _downKey) {
+        float offset = _ball.position.y - _paddle.position.y;
+
+        _input.SetKey(_upKey, offset > _paddle.scale.y * 0.25f);
+        _input.SetKey(_downKey, offset < _paddle.scale.y * -0.25f);
+    }
+
+    void RunMatches(std::vector<MatchResult> &_results, uint64_t _seed, unsigned int _ticks, unsigned int _threadCount) {
+        std::vector<std::thread> threads;
+
+        for (unsigned int t = 0; t < _threadCount; t++)
+        {
+            threads.emplace_back([&_results, _seed, _ticks, _threadCount, t]() {
+                for (size_t i = t; i < _results.size(); i += _threadCount)
+                    _results[i] = RunHeadlessMatch(_seed + i, _ticks);
+            });
+        }
+
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+}
+
+MatchResult RunHeadlessMatch(uint64_t _seed, unsigned int _ticks) {
+    Canis::ScriptedInput input;
+
+    World world;
+    world.input = &input;
+    world.fixedTimestep = true;
+    world.Seed(_seed);
+
+    vec2 viewport = world.GetViewportSize();
+
+    Ball *ball = world.Instantiate<Ball>();
+
+    Paddle *left = world.Instantiate<Paddle>("LeftPaddle");
+    Paddle *right = world.Instantiate<Paddle>("RightPaddle");
+
+    // paddles start at a random height so every seed plays a different match
+    left->Teleport(vec3(10.0f*0.5f, viewport.y * 0.5f + (world.random.Range(200) - 100.0f), 0.0f));
+    right->Teleport(vec3(viewport.x - (10.0f*0.5f), viewport.y * 0.5f + (world.random.Range(200) - 100.0f), 0.0f));
+
+    MatchResult result;
+    input.SetKey(SDL_SCANCODE_SPACE, true);
+
+    for (unsigned int tick = 0; tick < _ticks; tick++)
+    {
+        DrivePaddle(input, *left, *ball, SDL_SCANCODE_W, SDL_SCANCODE_S);
+        DrivePaddle(input, *right, *ball, SDL_SCANCODE_UP, SDL_SCANCODE_DOWN);
+
+        float ballX = ball->position.x;
+        bool inPlay = ball->dir != vec2(0.0f);
+
+        world.Step(world.fixedDeltaTime);
+
+        // the ball goes back to the middle and stops whenever someone scores
+        if (inPlay && ball->dir == vec2(0.0f))
+        {
+            if (ballX > viewport.x * 0.5f)
+                result.leftPoints++;
+            else
+                result.rightPoints++;
+        }
+
+        result.checksum = Canis::Random::Hash(result.checksum, FloatBits(ball->position.x), FloatBits(ball->position.y));
+        result.checksum = Canis::Random::Hash(result.checksum, FloatBits(left->position.y), FloatBits(right->position.y));
+    }
+
+    return result;
+}
+
+void RunHeadlessMatches(unsigned int _matchCount, unsigned int _ticks, uint64_t _seed) {
+    unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<MatchResult> results(_matchCount);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    RunMatches(results, _seed, _ticks, threadCount);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    unsigned int leftPoints = 0;
+    unsigned int rightPoints = 0;
+
+    for (const MatchResult &result : results)
+    {
+        leftPoints += result.leftPoints;
+        rightPoints += result.rightPoints;
+    }
+
+    Canis::Log("headless " + std::to_string(_matchCount) + " matches of " + std::to_string(_ticks) + " ticks on " +
+               std::to_string(threadCount) + " threads: " + std::to_string(_matchCount / seconds) + " matches/s, points left " +
+               std::to_string(leftPoints) + " right " + std::to_string(rightPoints));
+
+    // the same seeds on a different number of threads must land on the same results
+    std::vector<MatchResult> replay(_matchCount);
+    RunMatches(replay, _seed, _ticks, 1);
+
+    for (unsigned int i = 0; i < _matchCount; i++)
+    {
+        if (replay[i].checksum != results[i].checksum)
+        {
+            Canis::Error("headless match " + std::to_string(i) + " did not replay the same");
+            return;
+        }
+    }
+
+    Canis::Log("headless replay matched all " + std::to_string(_matchCount) + " matches");
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+struct MatchResult {
+    unsigned int leftPoints = 0;
+    unsigned int rightPoints = 0;
+    uint32_t checksum = 0; // folds every tick's positions, equal checksums mean the matches played out bit for bit the same
+};
+
+// plays one bot against bot match in a world with no window, no GL and scripted input
+extern MatchResult RunHeadlessMatch(uint64_t _seed, unsigned int _ticks);
+
+// plays _matchCount matches spread over every hardware thread, logs matches per second
+// then replays them on one thread and reports whether every result matched
+// run with --headless, needs no window or GL context
+extern void RunHeadlessMatches(unsigned int _matchCount, unsigned int _ticks, uint64_t _seed);
@@ -1,6 +1,7 @@
 #include "Paddle.hpp"
 
 #include "World.hpp"
+#include "Ball.hpp"
 
 using namespace glm;
 
@@ -9,35 +10,60 @@ void Paddle::Start() {
 }
 
 void Paddle::Update(float _dt) {
-    vec2 dir;
+    vec2 dir = vec2(0.0f);
 
     if (name == "LeftPaddle")
     {
-        dir.y += inputManager->GetKey(SDL_SCANCODE_W);
-        dir.y += inputManager->GetKey(SDL_SCANCODE_S) * -1;
+        dir.y += input->GetKey(SDL_SCANCODE_W);
+        dir.y += input->GetKey(SDL_SCANCODE_S) * -1;
     }
     else if (name == "RightPaddle")
     {
-        dir.y += inputManager->GetKey(SDL_SCANCODE_UP);
-        dir.y += inputManager->GetKey(SDL_SCANCODE_DOWN) * -1;
+        dir.y += input->GetKey(SDL_SCANCODE_UP);
+        dir.y += input->GetKey(SDL_SCANCODE_DOWN) * -1;
     }
 
     position.y += dir.y * speed * _dt;
 
-    if (position.y > window->GetScreenHeight() - (scale.y * 0.5f))
-        position.y = window->GetScreenHeight() - (scale.y * 0.5f);
+    float height = world->GetViewportSize().y;
+
+    if (position.y > height - (scale.y * 0.5f))
+        position.y = height - (scale.y * 0.5f);
     if (position.y < scale.y * 0.5f)
         position.y = scale.y * 0.5f;
+
+    // the paddle asks the broad phase for nearby balls so cost does not grow with every ball in the world
+    Canis::AABB2D bounds = world->GetBounds2D(*this);
+    world->QueryAABB(bounds, m_nearby);
+
+    for (Entity* entity : m_nearby)
+    {
+        Ball* ball = dynamic_cast<Ball*>(entity);
+        if (ball == nullptr)
+            continue;
+
+        Canis::AABB2D ballBounds = world->GetBounds2D(*ball);
+        if (!Canis::AABBOverlap2D(bounds, ballBounds))
+            continue;
+
+        // bounce away from whichever side the paddle is on
+        if (bounds.min.x + bounds.max.x < ballBounds.min.x + ballBounds.max.x)
+            ball->dir.x = abs(ball->dir.x);
+        else
+            ball->dir.x = abs(ball->dir.x) * -1.0f;
+    }
 }
 
-void Paddle::Draw() {
-    mat4 transform = mat4(1.0f);
-    transform = translate(transform, position);
-    transform = glm::scale(transform, scale);
+void Paddle::Draw(Canis::RenderQueue &_queue) {
+    Canis::RenderCommand command;
+    command.shader = &shader;
+    command.texture = texture.id;
+    command.vao = world->VAO;
+    command.indexCount = 6;
+    command.transform = world->GetWorldMatrix(*this);
+    command.color = color;
 
-    // set shader variables
-    shader.SetVec4("COLOR", color);
-    shader.SetMat4("TRANSFORM", transform);
+    _queue.Submit(command, layer, translucent);
 }
 
 void Paddle::OnDestroy() {
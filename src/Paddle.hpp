@@ -8,8 +8,11 @@ class Paddle : public Entity {
 public:
     void Start();
     void Update(float _dt);
-    void Draw();
+    void Draw(Canis::RenderQueue &_queue);
     void OnDestroy();
 
     float speed = 50.0f;
+
+private:
+    std::vector<Entity*> m_nearby = {};
 };
\ No newline at end of file
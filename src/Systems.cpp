@@ -0,0 +1,177 @@
+#include "Systems.hpp"
+
+#include "World.hpp"
+
+using namespace glm;
+
+size_t SpawnBall(World &_world, const Canis::GLTexture &_texture) {
+    ComponentPools &c = _world.components;
+    size_t row = c.Add();
+
+    vec2 viewport = _world.GetViewportSize();
+    c.position[row] = vec3(viewport.x * 0.5f, viewport.y * 0.5f, 0.0f);
+    c.previousPosition[row] = c.position[row];
+    c.scale[row] = vec3(100.0f, 100.0f, 0.0f);
+    c.speed[row] = 100.0f;
+    c.texture[row] = _texture;
+    c.tag[row] = TAG_BALL;
+
+    return row;
+}
+
+size_t SpawnPaddle(World &_world, const Canis::GLTexture &_texture, float _x, unsigned int _upKey, unsigned int _downKey) {
+    ComponentPools &c = _world.components;
+    size_t row = c.Add();
+
+    c.position[row] = vec3(_x, _world.GetViewportSize().y * 0.5f, 0.0f);
+    c.previousPosition[row] = c.position[row];
+    c.scale[row] = vec3(20.0f, 100.0f, 0.0f);
+    c.speed[row] = 50.0f;
+    c.texture[row] = _texture;
+    c.tag[row] = TAG_PADDLE;
+    c.inputKeys[row] = uvec2(_upKey, _downKey);
+
+    return row;
+}
+
+void PaddleInputSystem(World &_world) {
+    ComponentPools &c = _world.components;
+    size_t count = c.Count();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (c.inputKeys[i] == uvec2(0u))
+            continue;
+
+        float y = 0.0f;
+        y += _world.input->GetKey(c.inputKeys[i].x);
+        y += _world.input->GetKey(c.inputKeys[i].y) * -1.0f;
+        c.direction[i] = vec2(0.0f, y);
+    }
+}
+
+void BallSystem(World &_world) {
+    ComponentPools &c = _world.components;
+    size_t count = c.Count();
+    float width = _world.GetViewportSize().x;
+    float height = _world.GetViewportSize().y;
+    bool serve = _world.input->GetKey(SDL_SCANCODE_SPACE);
+
+    // serves pick their direction on the main thread before the rows are split
+    if (serve)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (c.tag[i] == TAG_BALL && c.direction[i] == vec2(0.0f))
+            {
+                vec2 directions[] = {vec2(1.0f, 1.0f), vec2(1.0f, -1.0f), vec2(-1.0f, 1.0f), vec2(-1.0f, -1.0f)};
+                c.direction[i] = directions[_world.TickRandom(i) % 4];
+            }
+        }
+    }
+
+    // every ball only touches its own row so the rows are split across the job system
+    _world.ParallelFor(count, [&](size_t _begin, size_t _end) {
+        for (size_t i = _begin; i < _end; i++)
+        {
+            if (c.tag[i] != TAG_BALL)
+                continue;
+
+            vec3 &position = c.position[i];
+            vec3 &scale = c.scale[i];
+            vec2 &dir = c.direction[i];
+
+            if (position.y > height - (scale.y * 0.5f)) {
+                position.y = height - (scale.y * 0.5f);
+                dir.y = abs(dir.y) * -1.0f;
+            }
+            if (position.y < scale.y * 0.5f) {
+                position.y = scale.y * 0.5f;
+                dir.y = abs(dir.y);
+            }
+
+            // detect score
+            if (position.x > width - (scale.x * 0.5f) || position.x < scale.x * 0.5f) {
+                position = vec3(width * 0.5f, height * 0.5f, 0.0f);
+                c.previousPosition[i] = position; // teleport, do not interpolate across the screen
+                dir = vec2(0.0f);
+            }
+        }
+    });
+}
+
+void CollisionSystem(World &_world) {
+    ComponentPools &c = _world.components;
+    size_t count = c.Count();
+
+    _world.UpdateComponentBroadPhase();
+
+    // paddles are few, so each one asks the broad phase for the balls around it
+    std::vector<unsigned int> &hits = _world.scratchIds;
+
+    for (size_t p = 0; p < count; p++)
+    {
+        if (c.tag[p] != TAG_PADDLE)
+            continue;
+
+        hits.clear();
+        _world.componentBroadPhase.QueryAABB(c.Bounds2D(p), hits);
+
+        for (unsigned int i : hits)
+        {
+            if (c.tag[i] != TAG_BALL)
+                continue;
+
+            // bounce away from whichever side the paddle is on
+            if (c.position[p].x < c.position[i].x)
+                c.direction[i].x = abs(c.direction[i].x);
+            else
+                c.direction[i].x = abs(c.direction[i].x) * -1.0f;
+        }
+    }
+}
+
+void MovementSystem(World &_world, float _dt) {
+    ComponentPools &c = _world.components;
+    size_t count = c.Count();
+
+    _world.ParallelFor(count, [&](size_t _begin, size_t _end) {
+        for (size_t i = _begin; i < _end; i++)
+        {
+            float step = c.speed[i] * _dt;
+            c.position[i].x += c.direction[i].x * step;
+            c.position[i].y += c.direction[i].y * step;
+        }
+    });
+}
+
+void PaddleBoundsSystem(World &_world) {
+    ComponentPools &c = _world.components;
+    size_t count = c.Count();
+    float height = _world.GetViewportSize().y;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (c.tag[i] != TAG_PADDLE)
+            continue;
+
+        float halfHeight = c.scale[i].y * 0.5f;
+
+        if (c.position[i].y > height - halfHeight)
+            c.position[i].y = height - halfHeight;
+        if (c.position[i].y < halfHeight)
+            c.position[i].y = halfHeight;
+    }
+}
+
+void RenderSystem(World &_world, Canis::SpriteBatch &_spriteBatch) {
+    ComponentPools &c = _world.components;
+    size_t count = c.Count();
+
+    float alpha = _world.GetInterpolationAlpha();
+
+    // rows outside the frustum were marked by World::CullRows
+    for (size_t i = 0; i < count; i++)
+        if (_world.IsVisible(i))
+            _spriteBatch.Draw(mix(c.previousPosition[i], c.position[i], alpha), c.scale[i], c.color[i], c.uv[i], c.texture[i]);
+}
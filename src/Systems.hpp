@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Components.hpp"
+
+class World;
+
+namespace Canis
+{
+    class SpriteBatch;
+}
+
+// gameplay for the component storage mode, each system is a linear pass over World::components
+// these mirror Ball::Update and Paddle::Update so both storage modes play the same game
+
+size_t SpawnBall(World &_world, const Canis::GLTexture &_texture);
+size_t SpawnPaddle(World &_world, const Canis::GLTexture &_texture, float _x, unsigned int _upKey, unsigned int _downKey);
+
+void PaddleInputSystem(World &_world);
+void BallSystem(World &_world);
+void CollisionSystem(World &_world);
+void MovementSystem(World &_world, float _dt);
+void PaddleBoundsSystem(World &_world);
+void RenderSystem(World &_world, Canis::SpriteBatch &_spriteBatch);
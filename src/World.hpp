@@ -1,75 +1,694 @@
 #pragma once
 
 #include <vector>
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <typeindex>
+#include <cmath>
 
 #include <SDL.h>
 #include <GL/glew.h>
 
 #include "Entity.hpp"
+#include "Components.hpp"
+#include "Systems.hpp"
+#include "Canis/SpriteBatch.hpp"
+#include "Canis/ObjectPool.hpp"
+#include "Canis/SpatialHash.hpp"
+#include "Canis/JobSystem.hpp"
+#include "Canis/TransformPool.hpp"
+#include "Canis/RenderQueue.hpp"
+#include "Canis/FrustumCuller.hpp"
+#include "Canis/PickingBuffer.hpp"
+#include "Canis/GLState.hpp"
+#include "Canis/Random.hpp"
+#include "Canis/InputSource.hpp"
+
+enum class StorageMode {
+    OBJECTS,    // Entity subclasses allocated from per type pools and updated through virtual calls
+    COMPONENTS  // rows in World::components updated by the functions in Systems.hpp
+};
 
 class World {
 public:
     unsigned int VAO;
-    Canis::Window *window;
-    Canis::InputManager *inputManager;
+    Canis::Window *window = nullptr; // leave unset to run headless, no GL is touched by Step
+    Canis::InputSource *input = nullptr; // keyboard when playing, a ScriptedInput for bots and replays
+    glm::vec2 viewport = glm::vec2(640.0f, 640.0f); // play area used when there is no window
+    Canis::SpriteBatch *spriteBatch = nullptr; // when set entities are drawn in batches instead of one draw call each
+    Canis::JobSystem *jobSystem = nullptr; // when set the simulate phase is spread across its workers
+
+    StorageMode storageMode = StorageMode::OBJECTS;
+
+    // for serial code, parallel updates should use TickRandom
+    Canis::Random random;
+
+    // tick the simulation at a fixed rate and interpolate positions when drawing
+    bool fixedTimestep = false;
+    float fixedDeltaTime = 1.0f / 60.0f;
+    unsigned int maxStepsPerFrame = 5;
 
     std::vector<Entity*> entities = {};
+    ComponentPools components = {};
+    std::vector<unsigned int> scratchIds = {};
+
+    // broad phase for each storage mode, user ids are slot indices for entities and rows for components
+    Canis::SpatialHash entityBroadPhase;
+    Canis::SpatialHash componentBroadPhase;
+
+    // cached world matrices for entities, rebuilt before drawing and only where something moved
+    Canis::TransformPool transforms;
+
+    // draws submitted by entities when there is no sprite batch, set its camera before Update
+    Canis::RenderQueue renderQueue;
 
+    // set from the camera before Update, sprites entirely outside it are not drawn
+    // the default frustum contains everything, so a world nobody points a camera at still draws
+    Canis::Frustum frustum;
+    bool frustumCulling = true;
+
+    // the pools only hand back memory, so every live entity gets OnDestroy and its destructor here first
+    ~World() {
+        // OnDestroy may instantiate, those are destroyed on the next pass
+        while (!entities.empty())
+        {
+            for (Entity* e : entities)
+                Destroy(e);
+
+            FlushDestroyed();
+        }
+    }
+
+    // _name is set before Start and indexed after it, so Start may still rename the entity
     template<typename T>
-    T* Instantiate() {
-        T* entity = new T;
+    T* Instantiate(const std::string &_name = "") {
+        Canis::ObjectPool<T> &pool = GetPool<T>();
+        T* entity = pool.Allocate();
         entity->window = window;
-        entity->inputManager;
+        entity->input = input;
         entity->world = this;
+        entity->name = _name;
+        entity->handle = AllocateSlot((Entity*)entity, &pool, entity);
         entity->Start();
-        entities.push_back((Entity*)entity);
+        entity->previousPosition = entity->position;
+        entity->transform = transforms.Create(entity->position, entity->scale);
+
+        if (!entity->name.empty())
+            LinkName(entity->handle.index, entity->name);
+
+        m_slots[entity->handle.index].proxy = entityBroadPhase.Insert(entity->handle.index, GetBounds2D(*entity));
+
         return entity;
     }
 
-    void Update(glm::mat4 _view, glm::mat4 _projection, float _dt) {
+    // the camera and time come from the FrameData uniform buffer written before this
+    void Update(float _dt) {
+        Step(_dt);
+
+        if (spriteBatch != nullptr)
+        {
+            Render();
+            return;
+        }
+
+        if (storageMode == StorageMode::COMPONENTS)
+        {
+            Canis::Error("World in COMPONENTS storage mode needs a spriteBatch to render");
+            return;
+        }
+
+        UpdateTransforms();
+        CullEntities();
+
+        for(size_t i = 0; i < entities.size(); i++)
+            if (m_culler.IsVisible(i))
+                entities[i]->Draw(renderQueue);
+
+        renderQueue.Execute();
+    }
+
+    // advances the simulation by _dt of real time
+    // with fixedTimestep on this runs however many fixedDeltaTime ticks fit and keeps the rest for next frame
+    void Step(float _dt) {
+        if (!fixedTimestep)
+        {
+            m_interpolationAlpha = 1.0f;
+            Simulate(_dt);
+            FlushDestroyed();
+            return;
+        }
+
+        m_accumulator += _dt;
+        unsigned int steps = 0;
+
+        while (m_accumulator >= fixedDeltaTime && steps < maxStepsPerFrame)
+        {
+            StorePreviousPositions();
+            Simulate(fixedDeltaTime);
+            FlushDestroyed();
+
+            m_accumulator -= fixedDeltaTime;
+            steps++;
+        }
+
+        // a frame that could not keep up drops the backlog instead of adding to the next frame's work
+        if (m_accumulator >= fixedDeltaTime)
+            m_accumulator = std::fmod(m_accumulator, fixedDeltaTime);
+
+        m_interpolationAlpha = m_accumulator / fixedDeltaTime;
+    }
+
+    // the window size, or the virtual viewport in a headless world
+    glm::vec2 GetViewportSize() const {
+        if (window != nullptr)
+            return glm::vec2(window->GetScreenWidth(), window->GetScreenHeight());
+
+        return viewport;
+    }
+
+    // restarts the random sequences, two worlds with the same seed and the same input play out the same
+    void Seed(uint64_t _seed) {
+        m_seed = _seed;
+        m_tick = 0;
+        random.Seed(_seed);
+    }
+
+    // random number for _stream on the current tick, safe to call from parallel updates because it does
+    // not depend on which thread asks first, use something stable like a handle index for _stream
+    uint32_t TickRandom(uint32_t _stream) const {
+        return Canis::Random::Hash(m_seed, m_tick, _stream);
+    }
+
+    uint64_t GetTick() const { return m_tick; }
+
+    // sprites drawn and skipped by the last Update, entities or rows depending on the storage mode
+    Canis::CullStats GetCullStats() const { return m_culler.GetStats(); }
+
+    // one bounding sphere per entity in entities order, IsVisible on the culler answers for entity i
+    void CullEntities() {
+        m_culler.Clear();
+        m_culler.Reserve(entities.size());
+
         for(Entity* e : entities)
+            m_culler.Add(Canis::SpriteBounds(transforms.GetWorldMatrix(e->transform)));
+
+        m_culler.Cull(frustumCulling ? frustum : Canis::Frustum(), jobSystem);
+    }
+
+    // same for component rows, at the position they are drawn at this frame
+    void CullRows() {
+        size_t count = components.Count();
+
+        m_culler.Clear();
+        m_culler.Reserve(count);
+
+        for (size_t i = 0; i < count; i++)
+            m_culler.Add(Canis::SpriteBounds(glm::mix(components.previousPosition[i], components.position[i], m_interpolationAlpha), components.scale[i]));
+
+        m_culler.Cull(frustumCulling ? frustum : Canis::Frustum(), jobSystem);
+    }
+
+    bool IsVisible(size_t _index) const { return m_culler.IsVisible(_index); }
+
+    // how far rendering is between the previous tick and the current one
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+
+    glm::vec3 InterpolatedPosition(const Entity &_entity) const {
+        return glm::mix(_entity.previousPosition, _entity.position, m_interpolationAlpha);
+    }
+
+    // copies the interpolated position of every entity into its transform and rebuilds what changed
+    void UpdateTransforms() {
+        for(Entity* e : entities)
+            transforms.SetLocal(e->transform, InterpolatedPosition(*e), e->scale);
+
+        transforms.Update();
+    }
+
+    // _child's position becomes relative to _parent, pass nullptr to detach
+    void SetParent(Entity *_child, Entity *_parent) {
+        transforms.SetParent(_child->transform, _parent == nullptr ? Canis::TransformPool::INVALID_TRANSFORM : _parent->transform);
+    }
+
+    const glm::mat4 &GetWorldMatrix(const Entity &_entity) const {
+        return transforms.GetWorldMatrix(_entity.transform);
+    }
+
+    void StorePreviousPositions() {
+        for(Entity* e : entities)
+            e->previousPosition = e->position;
+
+        components.previousPosition = components.position;
+    }
+
+    // simulation only, no GL calls, so the parallel parts can run on any thread
+    void Simulate(float _dt) {
+        if (storageMode == StorageMode::COMPONENTS)
         {
+            PaddleInputSystem(*this);
+            BallSystem(*this);
+            CollisionSystem(*this);
+            MovementSystem(*this, _dt);
+            PaddleBoundsSystem(*this);
+            m_tick++;
+            return;
+        }
+
+        ParallelFor(entities.size(), [&](size_t _begin, size_t _end) {
+            for (size_t i = _begin; i < _end; i++)
+                entities[i]->ParallelUpdate(_dt);
+        });
+
+        // synced after the parallel pass so queries in Update see where everything moved this tick
+        UpdateEntityBroadPhase();
+
+        for(Entity* e : entities)
             e->Update(_dt);
 
-            e->shader.Use();
-            e->shader.SetFloat("TIME", SDL_GetTicks() / 1000.0f);
-            e->shader.SetMat4("PROJECTION", _projection);
-            e->shader.SetMat4("VIEW", _view);
+        m_tick++;
+    }
+
+    // calls _body(begin, end) over [0, _count) on the job system, or inline when there is none
+    template<typename F>
+    void ParallelFor(size_t _count, F &&_body) {
+        if (jobSystem == nullptr || !jobSystem->IsRunning() || _count < MIN_PARALLEL_COUNT)
+        {
+            _body(0, _count);
+            return;
+        }
 
-            e->Draw();
+        jobSystem->ParallelFor(_count, 0, _body);
+    }
 
-            glBindVertexArray(VAO);
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
-            e->shader.UnUse();
+    // moves every proxy whose entity changed since the last sync, untouched entities cost a compare
+    // once anything is parented the world matrices are rebuilt from the simulated positions first
+    void UpdateEntityBroadPhase() {
+        if (transforms.HasParents())
+        {
+            for(Entity* e : entities)
+                transforms.SetLocal(e->transform, e->position, e->scale);
+
+            transforms.Update();
+        }
+
+        for(Entity* e : entities)
+        {
+            unsigned int proxy = m_slots[e->handle.index].proxy;
+            Canis::AABB2D bounds = GetBounds2D(*e);
+
+            if (!(entityBroadPhase.GetBounds(proxy) == bounds))
+                entityBroadPhase.Update(proxy, bounds);
         }
     }
 
-    void Destroy(Entity *_entity) {
-        _entity->OnDestroy();
+    void UpdateComponentBroadPhase() {
+        size_t count = components.Count();
+
+        for (size_t i = 0; i < count; i++)
+        {
+            Canis::AABB2D bounds = components.Bounds2D(i);
+
+            if (components.proxy[i] == Canis::SpatialHash::INVALID_PROXY)
+                components.proxy[i] = componentBroadPhase.Insert(i, bounds);
+            else if (!(componentBroadPhase.GetBounds(components.proxy[i]) == bounds))
+                componentBroadPhase.Update(components.proxy[i], bounds);
+        }
+    }
+
+    // world space bounds from the entity's current position and scale
+    // a parented entity goes through its parent's world matrix as of the last broad phase sync
+    Canis::AABB2D GetBounds2D(const Entity &_entity) const {
+        unsigned int parent = transforms.GetParent(_entity.transform);
+        if (parent == Canis::TransformPool::INVALID_TRANSFORM)
+            return EntityBounds2D(_entity);
+
+        const glm::vec3 &p = _entity.position;
+        const glm::vec3 &s = _entity.scale;
+        glm::mat4 local = glm::mat4(s.x, 0.0f, 0.0f, 0.0f,
+                                    0.0f, s.y, 0.0f, 0.0f,
+                                    0.0f, 0.0f, s.z, 0.0f,
+                                    p.x, p.y, p.z, 1.0f);
+
+        return Canis::QuadBounds2D(transforms.GetWorldMatrix(parent) * local);
+    }
+
+    // entities whose bounds overlapped _bounds at the last broad phase sync, _results is cleared first
+    void QueryAABB(const Canis::AABB2D &_bounds, std::vector<Entity*> &_results) {
+        thread_local std::vector<unsigned int> ids;
+        ids.clear();
+        _results.clear();
+
+        entityBroadPhase.QueryAABB(_bounds, ids);
+
+        for (unsigned int slotIndex : ids)
+            _results.push_back(m_slots[slotIndex].entity);
+    }
+
+    // calls _callback(Entity&, Entity&) once for every pair of overlapping entities
+    template<typename F>
+    void ForEachOverlappingPair(F &&_callback) {
+        entityBroadPhase.ForEachPair([&](unsigned int _a, unsigned int _b) {
+            _callback(*m_slots[_a].entity, *m_slots[_b].entity);
+        });
+    }
 
-        for(int i = 0; i < entities.size(); i++)
+    void RemoveRow(size_t _row) {
+        size_t last = components.Count() - 1;
+
+        if (components.proxy[_row] != Canis::SpatialHash::INVALID_PROXY)
+            componentBroadPhase.Remove(components.proxy[_row]);
+
+        if (_row != last && components.proxy[last] != Canis::SpatialHash::INVALID_PROXY)
+            componentBroadPhase.SetUserId(components.proxy[last], _row);
+
+        components.Remove(_row);
+    }
+
+    void ClearRows() {
+        components.Clear();
+        componentBroadPhase.Clear();
+    }
+
+    // fills the sprite batch without touching the GPU
+    void SubmitSprites() {
+        spriteBatch->Begin();
+
+        if (storageMode == StorageMode::COMPONENTS)
         {
-            if (_entity == entities[i])
+            CullRows();
+            RenderSystem(*this, *spriteBatch);
+            return;
+        }
+
+        UpdateTransforms();
+        CullEntities();
+
+        for(size_t i = 0; i < entities.size(); i++)
+        {
+            if (!m_culler.IsVisible(i))
+                continue;
+
+            Entity* e = entities[i];
+            spriteBatch->Draw(transforms.GetWorldMatrix(e->transform), e->color, e->uv, e->texture);
+        }
+    }
+
+    void Render() {
+        SubmitSprites();
+        spriteBatch->End();
+        spriteBatch->Render();
+    }
+
+    // draws every entity that passed this frame's cull with its picking id and queues a read of _pixel
+    // call after Update so transforms and culling are current, component rows have no handle and are not drawn
+    void RenderPicking(Canis::PickingBuffer &_picking, Canis::Shader &_idShader, glm::ivec2 _pixel) {
+        _picking.Begin();
+
+        Canis::GLState::SetBlend(false);
+        _idShader.Use();
+        Canis::GLState::BindVertexArray(VAO);
+
+        if (storageMode == StorageMode::OBJECTS)
+        {
+            for(size_t i = 0; i < entities.size(); i++)
             {
-                entities.erase(entities.begin() + i);
-                break;
+                if (!m_culler.IsVisible(i))
+                    continue;
+
+                Entity* e = entities[i];
+                _idShader.SetMat4("model", transforms.GetWorldMatrix(e->transform));
+                _idShader.SetInt("entityID", PickingID(e->handle));
+                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
             }
         }
 
-        delete _entity;
+        // Window::Create leaves blending on for everything else
+        Canis::GLState::SetBlend(true);
+
+        _picking.End(_pixel);
+    }
+
+    // the entity the last finished read found, nullptr over empty space or once that entity is destroyed
+    Entity* GetPickedEntity(const Canis::PickingBuffer &_picking) {
+        int id = _picking.GetID();
+        if (id == Canis::PickingBuffer::NO_ID)
+            return nullptr;
+
+        unsigned int index = (unsigned int)id & PICKING_INDEX_MASK;
+        if (index >= m_slots.size() || m_slots[index].pendingDestroy)
+            return nullptr;
+
+        // the read is a frame or two old, the generation bits catch a slot that was reused since
+        if ((m_slots[index].generation & PICKING_GENERATION_MASK) != ((unsigned int)id >> PICKING_INDEX_BITS))
+            return nullptr;
+
+        return m_slots[index].entity;
+    }
+
+    // the entity stays alive and resolvable until FlushDestroyed runs at the end of the frame
+    void Destroy(EntityHandle _handle) {
+        if (Resolve<Entity>(_handle) == nullptr || m_slots[_handle.index].pendingDestroy)
+            return;
+
+        m_slots[_handle.index].pendingDestroy = true;
+        m_destroyQueue.push_back(_handle);
+    }
+
+    void Destroy(Entity *_entity) {
+        Destroy(_entity->handle);
+    }
+
+    // swap and pop every queued entity, the last entity moves into the freed spot in entities
+    void FlushDestroyed() {
+        // OnDestroy may queue more entities so the size is read every pass
+        for (size_t i = 0; i < m_destroyQueue.size(); i++)
+        {
+            EntityHandle handle = m_destroyQueue[i];
+            Entity *entity = m_slots[handle.index].entity;
+
+            // OnDestroy may instantiate, so the slot reference is taken after it
+            entity->OnDestroy();
+            UnlinkName(handle.index);
+            entityBroadPhase.Remove(m_slots[handle.index].proxy);
+            transforms.Destroy(entity->transform);
+
+            EntitySlot &slot = m_slots[handle.index];
+
+            Entity *last = entities.back();
+            entities[slot.denseIndex] = last;
+            m_slots[last->handle.index].denseIndex = slot.denseIndex;
+            entities.pop_back();
+
+            Canis::PoolBase *pool = slot.pool;
+            void *allocation = slot.allocation;
+
+            slot.entity = nullptr;
+            slot.pool = nullptr;
+            slot.allocation = nullptr;
+            slot.generation++;
+            slot.pendingDestroy = false;
+            m_freeSlots.push_back(handle.index);
+
+            pool->Free(allocation);
+        }
+
+        m_destroyQueue.clear();
     }
 
     template<typename T>
-    T* FindByName(std::string _name) {
-        for(Entity* e : entities)
-            if (e->name == _name)
-                return (T*)e;
+    T* Resolve(EntityHandle _handle) {
+        if (_handle.index >= m_slots.size())
+            return (T*)nullptr;
+
+        EntitySlot &slot = m_slots[_handle.index];
+        if (slot.generation != _handle.generation)
+            return (T*)nullptr;
 
-        return (T*)nullptr;
+        return (T*)slot.entity;
     }
 
-    Entity* FindEntityByName(std::string _name) {
+    // returns the earliest created entity that still has this name
+    template<typename T>
+    T* FindByName(const std::string &_name) {
+        auto it = m_nameIds.find(_name);
+        if (it == m_nameIds.end())
+            return (T*)nullptr;
+
+        unsigned int slotIndex = m_nameBuckets[it->second].head;
+        if (slotIndex == INVALID_SLOT)
+            return (T*)nullptr;
+
+        return (T*)m_slots[slotIndex].entity;
+    }
+
+    Entity* FindEntityByName(const std::string &_name) {
         return FindByName<Entity>(_name);
     }
-};
\ No newline at end of file
+
+    void SetName(Entity *_entity, const std::string &_name) {
+        UnlinkName(_entity->handle.index);
+        _entity->name = _name;
+
+        if (!_name.empty())
+            LinkName(_entity->handle.index, _name);
+    }
+
+    // one pool per entity type, created the first time that type is instantiated
+    template<typename T>
+    Canis::ObjectPool<T>& GetPool() {
+        std::unique_ptr<Canis::PoolBase> &pool = m_pools[std::type_index(typeid(T))];
+
+        if (pool == nullptr)
+            pool = std::make_unique<Canis::ObjectPool<T>>();
+
+        return *static_cast<Canis::ObjectPool<T>*>(pool.get());
+    }
+
+    template<typename T>
+    Canis::PoolStats GetPoolStats() {
+        return GetPool<T>().GetStats();
+    }
+
+    // totals across every entity type
+    Canis::PoolStats GetPoolStats() {
+        Canis::PoolStats total = {};
+
+        for (auto &pair : m_pools)
+        {
+            const Canis::PoolStats &stats = pair.second->GetStats();
+            total.liveObjects += stats.liveObjects;
+            total.peakLiveObjects += stats.peakLiveObjects;
+            total.chunkCount += stats.chunkCount;
+            total.capacity += stats.capacity;
+        }
+
+        return total;
+    }
+
+private:
+    static constexpr unsigned int INVALID_SLOT = ~0u;
+    // below this many items handing work to other threads costs more than it saves
+    static constexpr size_t MIN_PARALLEL_COUNT = 256;
+
+    // picking ids are the slot index with the low generation bits above it, kept positive so they never hit NO_ID
+    static constexpr unsigned int PICKING_INDEX_BITS = 20;
+    static constexpr unsigned int PICKING_INDEX_MASK = (1u << PICKING_INDEX_BITS) - 1;
+    static constexpr unsigned int PICKING_GENERATION_MASK = (1u << (31 - PICKING_INDEX_BITS)) - 1;
+
+    static int PickingID(EntityHandle _handle) {
+        return (int)(((_handle.generation & PICKING_GENERATION_MASK) << PICKING_INDEX_BITS) | (_handle.index & PICKING_INDEX_MASK));
+    }
+
+    uint64_t m_seed = 0;
+    uint64_t m_tick = 0;
+
+    float m_accumulator = 0.0f;
+    float m_interpolationAlpha = 1.0f;
+
+    Canis::FrustumCuller m_culler;
+
+    struct EntitySlot {
+        Entity *entity = nullptr;
+        Canis::PoolBase *pool = nullptr;
+        void *allocation = nullptr; // the T* handed out by pool, may differ from entity under multiple inheritance
+        unsigned int generation = 0;
+        unsigned int denseIndex = 0;
+        bool pendingDestroy = false;
+        unsigned int proxy = Canis::SpatialHash::INVALID_PROXY;
+
+        // entities sharing a name form a list in creation order
+        unsigned int nameId = INVALID_SLOT;
+        unsigned int prevWithName = INVALID_SLOT;
+        unsigned int nextWithName = INVALID_SLOT;
+    };
+
+    struct NameBucket {
+        unsigned int head = INVALID_SLOT;
+        unsigned int tail = INVALID_SLOT;
+    };
+
+    std::vector<EntitySlot> m_slots = {};
+    std::vector<unsigned int> m_freeSlots = {};
+    std::vector<EntityHandle> m_destroyQueue = {};
+
+    std::unordered_map<std::type_index, std::unique_ptr<Canis::PoolBase>> m_pools = {};
+
+    // names are interned once, after that the index is a plain array lookup
+    std::unordered_map<std::string, unsigned int> m_nameIds = {};
+    std::vector<NameBucket> m_nameBuckets = {};
+
+    EntityHandle AllocateSlot(Entity *_entity, Canis::PoolBase *_pool, void *_allocation) {
+        unsigned int index;
+
+        if (m_freeSlots.empty())
+        {
+            index = m_slots.size();
+            m_slots.push_back({});
+        }
+        else
+        {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+
+        EntitySlot &slot = m_slots[index];
+        slot.entity = _entity;
+        slot.pool = _pool;
+        slot.allocation = _allocation;
+        slot.denseIndex = entities.size();
+        entities.push_back(_entity);
+
+        return {index, slot.generation};
+    }
+
+    unsigned int InternName(const std::string &_name) {
+        auto it = m_nameIds.find(_name);
+        if (it != m_nameIds.end())
+            return it->second;
+
+        unsigned int id = m_nameBuckets.size();
+        m_nameIds[_name] = id;
+        m_nameBuckets.push_back({});
+        return id;
+    }
+
+    void LinkName(unsigned int _slotIndex, const std::string &_name) {
+        unsigned int nameId = InternName(_name);
+        EntitySlot &slot = m_slots[_slotIndex];
+        NameBucket &bucket = m_nameBuckets[nameId];
+
+        slot.nameId = nameId;
+        slot.prevWithName = bucket.tail;
+        slot.nextWithName = INVALID_SLOT;
+
+        if (bucket.tail != INVALID_SLOT)
+            m_slots[bucket.tail].nextWithName = _slotIndex;
+        else
+            bucket.head = _slotIndex;
+
+        bucket.tail = _slotIndex;
+    }
+
+    void UnlinkName(unsigned int _slotIndex) {
+        EntitySlot &slot = m_slots[_slotIndex];
+        if (slot.nameId == INVALID_SLOT)
+            return;
+
+        NameBucket &bucket = m_nameBuckets[slot.nameId];
+
+        if (slot.prevWithName != INVALID_SLOT)
+            m_slots[slot.prevWithName].nextWithName = slot.nextWithName;
+        else
+            bucket.head = slot.nextWithName;
+
+        if (slot.nextWithName != INVALID_SLOT)
+            m_slots[slot.nextWithName].prevWithName = slot.prevWithName;
+        else
+            bucket.tail = slot.prevWithName;
+
+        slot.nameId = INVALID_SLOT;
+        slot.prevWithName = INVALID_SLOT;
+        slot.nextWithName = INVALID_SLOT;
+    }
+};
@@ -11,10 +11,19 @@
 #include "Canis/Canis.hpp"
 #include "Canis/IOManager.hpp"
 #include "Canis/FrameRateManager.hpp"
+#include "Canis/InputManager.hpp"
+#include "Canis/SpriteBatch.hpp"
+#include "Canis/GLState.hpp"
+#include "Canis/FrameData.hpp"
+#include "Canis/PickingBuffer.hpp"
+#include "Canis/ProgramCache.hpp"
+#include "Canis/ShaderLibrary.hpp"
 
 #include "Entity.hpp"
 #include "Ball.hpp"
 #include "Paddle.hpp"
+#include "Benchmark.hpp"
+#include "Headless.hpp"
 
 // git restore .
 // git fetch
@@ -33,6 +42,23 @@ extern "C" int main(int argc, char *argv[])
 int main(int argc, char *argv[])
 #endif
 {
+    // headless runs never open a window or touch GL
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--headless")
+        {
+            RunHeadlessMatches(1000, 60 * 60, 1);
+            return 0;
+        }
+
+        // compile every shader from source, to compare startup with and without the cache
+        if (std::string(argv[i]) == "--no-shader-cache")
+            Canis::SetProgramCacheDirectory("");
+    }
+
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+    bool firstFrame = true;
+
     Canis::Init();
 
     Canis::Window window;
@@ -44,55 +70,103 @@ int main(int argc, char *argv[])
     float deltaTime = 0.0f;
     float fps = 0.0f;
 
-    Canis::Shader spriteShader;
-    spriteShader.Compile("assets/shaders/sprite.vs", "assets/shaders/sprite.fs");
-    spriteShader.AddAttribute("aPos");
-    spriteShader.AddAttribute("aUV");
-    spriteShader.Link();
+    // every shader builds at once, the rest of loading runs while the driver compiles them
+    Canis::ShaderLibrary shaders;
+    shaders.Add("sprite", "assets/shaders/sprite.vs", "assets/shaders/sprite.fs", {"aPos", "aUV"});
+    shaders.Add("sprite_batch", "assets/shaders/sprite_batch.vs", "assets/shaders/sprite_batch.fs", {"aPos", "aUV", "aColor", "aSlot"});
+    shaders.Add("id", "assets/shaders/id_shader.vs", "assets/shaders/id_shader.fs", {"aPos"});
+    shaders.Build();
+
+    // entity ids under the cursor, read back a frame or two late so clicking never waits on the gpu
+    Canis::PickingBuffer picking;
+    picking.Init(window.GetScreenWidth(), window.GetScreenHeight());
 
     InitModel();
 
     Canis::GLTexture texture = Canis::LoadImageGL("assets/textures/ForcePush.png", true);
 
-    int textureSlots = 0;
+    Canis::Shader &spriteShader = *shaders.Get("sprite");
+    Canis::Shader &idShader = *shaders.Get("id");
 
-    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &textureSlots);
+    Canis::SpriteBatch spriteBatch;
+    spriteBatch.Init(shaders.Get("sprite_batch"));
 
-    Canis::Log(std::to_string(textureSlots));
+    // the batch spreads up to this many textures over the units before it needs another draw call
+    Canis::Log("sprite batch texture slots: " + std::to_string(spriteBatch.GetTextureSlotCount()));
 
+    spriteShader.Use();
     spriteShader.SetInt("texture1", 0);
 
-    glActiveTexture(GL_TEXTURE0 + 0);
-    glBindTexture(GL_TEXTURE_2D, texture.id);
+    Canis::GLState::BindTexture(0, GL_TEXTURE_2D, texture.id);
 
     World world;
     world.VAO = VAO;
     world.window = &window;
-    world.inputManager = &inputManager;
+    world.input = &inputManager;
+    world.spriteBatch = &spriteBatch;
+    world.jobSystem = &Canis::GetJobSystem();
+    world.fixedTimestep = true;
 
-    Ball *ball = world.Instantiate<Ball>();
-    ball->shader = spriteShader;
-    ball->texture = texture;
+    bool runBenchmark = false;
+    bool logGLStats = false;
 
+    for (int i = 1; i < argc; i++)
     {
-        Paddle *paddle = world.Instantiate<Paddle>();
-        paddle->shader = spriteShader;
-        paddle->texture = texture;
-        paddle->name = "RightPaddle";
-        paddle->position = glm::vec3(window.GetScreenWidth() - (10.0f*0.5f), window.GetScreenHeight() * 0.5f, 0.0f);
+        std::string arg = argv[i];
+        if (arg == "--components")
+            world.storageMode = StorageMode::COMPONENTS;
+        if (arg == "--benchmark")
+            runBenchmark = true;
+        if (arg == "--variable-timestep")
+            world.fixedTimestep = false;
+        if (arg == "--gl-stats")
+            logGLStats = true;
     }
 
+    if (runBenchmark)
     {
-        Paddle *paddle = world.Instantiate<Paddle>();
-        paddle->shader = spriteShader;
-        paddle->texture = texture;
-        paddle->name = "LeftPaddle";
-        paddle->position = glm::vec3(10.0f*0.5f, window.GetScreenHeight() * 0.5f, 0.0f);
+        RunStorageBenchmark(world);
+        RunOverlapBenchmark();
+        RunRenderQueueBenchmark();
+        return 0;
     }
 
+    if (world.storageMode == StorageMode::COMPONENTS)
+    {
+        SpawnBall(world, texture);
+        SpawnPaddle(world, texture, window.GetScreenWidth() - (10.0f*0.5f), SDL_SCANCODE_UP, SDL_SCANCODE_DOWN);
+        SpawnPaddle(world, texture, 10.0f*0.5f, SDL_SCANCODE_W, SDL_SCANCODE_S);
+    }
+    else
+    {
+        Ball *ball = world.Instantiate<Ball>();
+        ball->shader = spriteShader;
+        ball->texture = texture;
+
+        {
+            Paddle *paddle = world.Instantiate<Paddle>("RightPaddle");
+            paddle->shader = spriteShader;
+            paddle->texture = texture;
+            paddle->Teleport(glm::vec3(window.GetScreenWidth() - (10.0f*0.5f), window.GetScreenHeight() * 0.5f, 0.0f));
+        }
+
+        {
+            Paddle *paddle = world.Instantiate<Paddle>("LeftPaddle");
+            paddle->shader = spriteShader;
+            paddle->texture = texture;
+            paddle->Teleport(glm::vec3(10.0f*0.5f, window.GetScreenHeight() * 0.5f, 0.0f));
+        }
+    }
+
+    unsigned int lastStatsSecond = 0;
+
+    Canis::FrameUniformBuffer frameUniforms;
+    frameUniforms.Init();
+
     while (inputManager.Update(window.GetScreenWidth(), window.GetScreenHeight()))
     {
         deltaTime = frameRateManager.StartFrame();
+        Canis::GLState::ResetStats();
         glClearColor( 1.0f, 1.0f, 1.0f, 1.0f);
 
         glClear(GL_COLOR_BUFFER_BIT);
@@ -105,10 +179,48 @@ int main(int argc, char *argv[])
         view = translate(view, vec3(0.0f, 0.0f, 0.5f));
         view = inverse(view);
 
-        world.Update(view, projection, deltaTime);
+        Canis::FrameData frameData;
+        frameData.view = view;
+        frameData.projection = projection;
+        frameData.cameraPosition = vec4(0.0f, 0.0f, 0.5f, 1.0f);
+        frameData.viewport = vec2(window.GetScreenWidth(), window.GetScreenHeight());
+        frameData.time = SDL_GetTicks() / 1000.0f;
+        frameData.deltaTime = deltaTime;
+        frameUniforms.Update(frameData);
+        world.renderQueue.SetCamera(view, 0.001f, 100.0f);
+        world.frustum = Canis::Frustum::FromViewProjection(frameUniforms.GetData().viewProjection);
+
+        world.Update(deltaTime);
+
+        picking.Resize(window.GetScreenWidth(), window.GetScreenHeight());
+        world.RenderPicking(picking, idShader, glm::ivec2(inputManager.mouse));
+
+        if (inputManager.JustLeftClicked())
+        {
+            Entity *picked = world.GetPickedEntity(picking);
+            Canis::Log(picked == nullptr ? std::string("picked nothing") : "picked " + (picked->name.empty() ? std::string("unnamed entity") : picked->name));
+        }
+
+        if (logGLStats && SDL_GetTicks() / 1000 != lastStatsSecond)
+        {
+            lastStatsSecond = SDL_GetTicks() / 1000;
+            Canis::GLStateStats stats = Canis::GLState::GetStats();
+            Canis::Log("gl state calls issued " + std::to_string(stats.issued) + ", skipped " + std::to_string(stats.skipped));
+            Canis::CullStats cull = world.GetCullStats();
+            Canis::Log("sprites visible " + std::to_string(cull.visible) + ", culled " + std::to_string(cull.culled));
+        }
 
         window.SwapBuffer();
 
+        if (firstFrame)
+        {
+            firstFrame = false;
+            Canis::ProgramCacheStats shaderStats = Canis::GetProgramCacheStats();
+            double startupMilliseconds = (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+            Canis::Log("first frame after " + std::to_string(startupMilliseconds) + " ms, shaders linked in " + std::to_string(shaderStats.linkMilliseconds) +
+                       " ms, program cache hits " + std::to_string(shaderStats.hits) + ", misses " + std::to_string(shaderStats.misses));
+        }
+
         fps = frameRateManager.EndFrame();
     }
 
@@ -133,12 +245,12 @@ void InitModel()
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
-    glBindVertexArray(VAO);
+    Canis::GLState::BindVertexArray(VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    Canis::GLState::BindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    Canis::GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)0);
@@ -147,6 +259,6 @@ void InitModel()
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    Canis::GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    Canis::GLState::BindVertexArray(0);
 }
\ No newline at end of file